@@ -16,12 +16,26 @@ public:
   // Each driver handles the internal timing breakdown (e.g. HIGH/LOW split) independently.
   virtual void step(unsigned long stepPeriodUs) = 0;
 
+  // Emit count steps back to back, periods[i] µs each. Lets the blocking cruise and creep
+  // loops pay the call and setup once per block instead of once per step.
+  // Default: step() per period; drivers override it with the loop inlined.
+  virtual void stepBurst(const unsigned long* periods, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) step(periods[i]);
+  }
+
+  // Emit one step immediately with no trailing delay. Used by the step timer ISR,
+  // which owns the period; must be short and safe to call with interrupts disabled.
+  virtual void pulse() = 0;
+
   // Set direction. forward = true moves toward the end limit in logical space.
   virtual void setDirection(bool forward) = 0;
 
   // Microsteps per revolution — matches the DIP-switch setting on this driver unit.
   virtual int stepsPerRev() const = 0;
 
+  // STEP output pin, for hardware pulse mode (MotorBase::attachPulseTimer); -1 = none.
+  virtual int stepPin() const { return -1; }
+
   // Enable / disable motor power. Default no-ops for drivers without an enable pin (e.g. STR3).
   virtual void enable()  {}
   virtual void disable() {}
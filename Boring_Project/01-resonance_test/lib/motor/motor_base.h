@@ -2,18 +2,130 @@
 // Base class for all stepper motor axes.
 // Owns motion profile logic and delegates all hardware access to a StepperDriver.
 // Subclasses add limit switches (LinearMotor) or nothing extra (RotationalMotor).
+//
+// Every move is planned into a step-period generator (nextStepPeriod) that is drained either
+// by a blocking driver->step() loop or, after attachStepTimer(), by a hardware timer ISR
+// that emits each pulse and loads the next period in the background.
+//
+// Each move comes in two forms: the blocking call (manualTrapMove, ...) and a start… variant
+// that returns at once. A started move runs in the timer ISR, or without a timer, on every
+// poll() from loop(); waitDone() blocks until it ends. The blocking calls are start + waitDone.
+//
+// Planning runs in Q16.16 fixed point (rev, rev/s, rev/s², s — see util/fixed.h) and the
+// default RAMP_AUSTIN generator in integer Q20.12 µs periods, so it runs no float math per
+// step or in the ISR. RAMP_SQRT (setRampMode(), kept for A/B comparison) still takes a float
+// sqrt() and divide per ramp step.
 
 #pragma once
 
 #include <Arduino.h>
 #include "../driver/stepper_driver.h"
+#include "../util/fixed.h"
+#include "ramp_table.h"
+#include "step_jitter.h"
+#include "torque_curve.h"
+
+class MotionGroup;
+class MoveQueue;
 
 class MotorBase {
+  friend class MotionGroup;   // drives follower axes and the master's generator in a linear move
+  friend class MoveQueue;     // chains pre-planned segments into the generator
+
 public:
+  // Ramp period generator for accel, decel and limit-decel steps.
+  // RAMP_AUSTIN (default): integer Austin/Eiderman recurrence, one 32-bit divide per step.
+  // RAMP_SQRT: v = sqrt(2·a·n) per step in float (~175 µs/step on AVR) — kept for comparison.
+  enum RampMode : uint8_t { RAMP_AUSTIN, RAMP_SQRT };
+
+  // Blocking cruise and creep steps go to the driver in bursts (StepperDriver::stepBurst) of
+  // at most STEP_BURST steps spanning at most BURST_SPAN_US. Limits and sensors are checked
+  // between bursts, so a trip is seen at most BURST_SPAN_US + one period after it happens;
+  // at periods above BURST_SPAN_US every burst is a single step, as before.
+  static const uint8_t  STEP_BURST    = 16;
+  static const uint16_t BURST_SPAN_US = 2000;
+
   // Configure the motor axis. driver must outlive this object.
   // Calls driver->init(), caches stepsPerRev for fast access in tight loops.
   void init(uint8_t id, StepperDriver* driver);
 
+  // Claim a free hardware step timer (see step_timer.h). Moves are then clocked by the
+  // timer ISR; the blocking move calls below start the move and wait for completion.
+  // Returns false when no timer is free — moves keep using the blocking step loop.
+  bool attachStepTimer();
+
+  // Claim the step timer whose output-compare pin is the driver's STEP pin (see step_timer.h
+  // for the Mega pins) in hardware pulse mode: the timer makes every step edge itself, so
+  // ISR latency and other interrupts no longer jitter the pulse train, and the ISR no longer
+  // holds the pin high for PULSE_US. Returns false when the driver has no STEP pin, the pin
+  // is not a timer output, or that timer is taken — nothing changes then.
+  bool attachPulseTimer();
+
+  // Release the step timer and fall back to the blocking step loop.
+  void detachStepTimer();
+
+  // Select the ramp generator used by subsequent moves.
+  void setRampMode(RampMode mode) { _rampMode = mode; }
+
+  // Record the timing of every step of the following moves in probe (see step_jitter.h);
+  // nullptr detaches it. The probe must outlive its use.
+  void setJitterProbe(StepJitter* probe) { _jitter = probe; }
+
+  // Closed-loop stall detection from the driver's tach output (STR3 Tach Out; pulsesPerRev
+  // as configured on the driver). tachPin must be an interrupt pin. Every generated step
+  // compares the steps taken in the move against the tach pulses counted; once the tach
+  // falls more than maxLagRevs behind, the move stops through the limit decel and stalled()
+  // reads true until the next move. The tach lags by up to one pulse in normal running, so
+  // keep maxLagRevs above 1 / pulsesPerRev. Returns false when all TACH_SLOTS are in use.
+  static const uint8_t TACH_SLOTS = 4;
+  bool attachTach(int tachPin, uint16_t pulsesPerRev, float maxLagRevs);
+  void detachTach();
+
+  // Acceleration ceiling (rev/s²) applied to MoveQueue runs and jogs on this axis; 0 = none.
+  void  setMaxAccel(float revPerSec2) { _maxAccel = revPerSec2; }
+  float maxAccel() const              { return _maxAccel; }
+
+  // Distance (revs) a limit hit may take to stop the axis from maxRPS; sets the limit-decel
+  // rate of the next move. Default 2.
+  void  setLimitStopRevs(float revs)  { _limitStopRevs = revs; }
+  float limitStopRevs() const         { return _limitStopRevs; }
+
+  // Soft travel limits (steps): a window the planner keeps the axis in, short of any limit
+  // switch. A move, queued run, linear-group move or retarget whose target (any queued
+  // segment's end) falls outside is rejected before it starts — nothing moves, and the
+  // message says so. A jog aims at the window edge instead of running on, so it ramps down
+  // to rest on the edge at its own decel: near an end the speed is capped at what can still
+  // stop. Creeps (LinearMotor homing) ignore the window.
+  void setSoftLimits(long minSteps, long maxSteps);
+  void clearSoftLimits()     { _softLimits = false; }
+  bool softLimited() const   { return _softLimits; }
+
+  // Resonance bands: speed ranges (rev/s, open at both ends) this axis must not run in, as
+  // measured by the resonance sweeps. Every later move, queued segment, retarget and jog
+  // snaps its cruise speed out of a band to the nearer edge (the lower one when the upper
+  // is above maxRPS), and accel / decel ramps cross a band at boost × their rate. Table ramps
+  // stride through a band the same way; S-curve ramps and the limit decel are unchanged, and
+  // a table move whose top speed is in a band is only warned about. Up to MAX_BANDS bands;
+  // count 0 clears them. Returns false and keeps the old bands when a band is empty or not
+  // above 0 rps, or boost is 0. The timing report still expects the unboosted ramp times.
+  struct SpeedBand {
+    float loRPS, hiRPS;
+  };
+  static const uint8_t MAX_BANDS = 4;
+  bool setResonanceBands(const SpeedBand* bands, uint8_t count, uint8_t boost = 4);
+
+  // rps snapped out of the resonance bands as above; the sign is kept.
+  float safeSpeed(float rps) const;
+
+  // Copy the current bands into bands (room for MAX_BANDS) and the boost into *boost;
+  // returns the count.
+  uint8_t resonanceBands(SpeedBand* bands, uint8_t* boost = nullptr) const;
+
+  // Speed → accel limit followed by curveMove() (see torque_curve.h); nullptr detaches it.
+  // Builds the curve's zones in this axis' steps, after any running curve move has ended.
+  // The curve must outlive its use. Returns false when it has no points.
+  bool setTorqueCurve(TorqueCurve* curve);
+
   // Explicit 3-phase trapezoidal move (revolutions).
   // Sign of accelRevs sets direction; cruise and decel signs must match.
   // Accel rate: a = cruiseRPS² / (2 * |accelRevs|).
@@ -23,28 +135,109 @@ public:
   // when the distance cannot sustain a cruise phase.
   void autoTrapMove(float revolutions, float maxRPS, float totalTime);
 
+  // Replay a compile-time ramp table (see ramp_table.h): accel up the table, cruise at its
+  // top speed, decel back down the same table. Sign of revolutions sets direction.
+  // Ramps are shortened symmetrically (triangle) when the distance cannot hold both.
+  void tableTrapMove(const RampProfile& ramp, float revolutions);
+
+  // Jerk-limited 7-segment S-curve move. Acceleration ramps at maxJerk (rev/s³) up to
+  // maxAccel (rev/s²), holds, then ramps back to zero as speed reaches maxRPS; decel mirrors it.
+  // Peak speed (then peak accel) is lowered when the distance is too short to reach it.
+  // Jerk is capped at 1.16e8 steps/s³ (36 000 rev/s³ at 3200 spr) by the integer generator.
+  void sCurveMove(float revolutions, float maxRPS, float maxAccel, float maxJerk);
+
+  // Trapezoid whose ramps follow the torque curve (setTorqueCurve): each speed is passed at
+  // the accel the curve allows there, up to maxRPS and down the same curve. Sign of
+  // revolutions sets direction; the peak is lowered (triangle) when the ramps do not fit.
+  void curveMove(float revolutions, float maxRPS);
+
   // Constant-velocity move — no accel/decel ramp. Intended for jogging or resonance testing.
   void spinRevs(float revolutions, float rps);
 
-  // State getters used by Display and Serial output.
-  uint8_t id()           const { return _id; }
-  float   positionRevs() const { return (float)_position / _stepsPerRev; }
-  float   speedRPS()     const { return _speedRPS; }
-  bool    hasLimits()    const { return _hasLimits; }
-  float   mmPerRev()     const { return _mmPerRev; }
+  // ── Non-blocking moves ──
+  // Same arguments as the blocking moves above. Each waits for any running move to finish,
+  // plans and returns; the move starts on the step timer, or on the next poll() without one.
+  // Drive it with poll() (required without a step timer) or block on waitDone().
+  void startManualTrapMove(float accelRevs, float cruiseRevs, float decelRevs, float cruiseRPS);
+  void startAutoTrapMove(float revolutions, float maxRPS, float totalTime);
+  void startTableTrapMove(const RampProfile& ramp, float revolutions);
+  void startSCurveMove(float revolutions, float maxRPS, float maxAccel, float maxJerk);
+  void startCurveMove(float revolutions, float maxRPS);
+  void startSpinRevs(float revolutions, float rps);
+
+  // Advance a started move: emits the step that is due, if any, and delivers the completion
+  // event (timing report, then the move-done callback). Call often from loop(). Returns isBusy().
+  bool poll();
+
+  // Block until the current move has finished and its completion event has been delivered.
+  void waitDone();
+
+  // Fraction of the current (or last) move's distance covered, 0–1 (from the last retarget).
+  float progress() const;
+
+  // ── Retargeting a running move ──
+  // Replan a started move from its current speed toward a new absolute target (revolutions,
+  // as positionRevs()) and cruise speed, keeping the move's accel and decel rates: speeds up,
+  // slows to the new cruise, or stops and reverses when the target can no longer be reached
+  // going forward. Trapezoid, table, S-curve and curve moves continue as a trapezoid (a curve
+  // move at its average ramp rate); spins have no ramp and cannot be retargeted. The timing
+  // report is dropped. Returns false when no retargetable move is running (idle, finishing,
+  // or stopping on a limit).
+  bool retarget(float targetRevs, float cruiseRPS);
+
+  // Change only the cruise speed of the running move.
+  bool retargetSpeed(float cruiseRPS);
+
+  // ── Velocity (jog) mode ──
+  // Run continuously at rps (rev/s, sign = direction; 0 = stop), ramping every change at
+  // accel (rev/s²). Returns at once like the start… moves — keep calling poll() without a
+  // step timer. Calling again ramps from the current speed to the new one; a sign change
+  // decelerates to rest and reverses. Speed is capped at maxRPS, accel at setMaxAccel().
+  // A limit switch stops the axis through the normal limit decel (LinearMotor); while that
+  // stop runs the call returns false, and a jog back away from the switch is accepted after.
+  // Inside soft limits (setSoftLimits()) the jog stops on the window edge instead.
+  bool setTargetVelocity(float rps, float accel);
+
+  // Called from poll() / waitDone() — never from the ISR — once per finished move.
+  typedef void (*MoveDoneCallback)(MotorBase& motor);
+  void setMoveDoneCallback(MoveDoneCallback cb) { _doneCallback = cb; }
+
+  // State getters used by Display and Serial output. Safe to call while the timer runs a move.
+  uint8_t id()            const { return _id; }
+  long    positionSteps() const;
+  float   positionRevs()  const { return (float)positionSteps() / _stepsPerRev; }
+  float   speedRPS()      const;
+  bool    hasLimits()     const { return _hasLimits; }
+  float   mmPerRev()      const { return _mmPerRev; }
+  bool    isBusy()        const { return _busy; }
+  bool    stalled()       const { return _stalled; }   // last move stopped on a tach stall
+  bool    stoppedEarly()  const { return _limitHitPhase != PHASE_IDLE; }   // limit or stall
+  float   tachRevs()      const;                         // tach revolutions in the last move
+
+  // Called by the tach ISR stubs in motor_base.cpp — must be public.
+  void countTachPulse()   { _tachPulses++; }
 
   // Called by ISR stubs in linear_motor.cpp — must be public.
   void triggerEndLimit()  { _limitEndFlag  = true; }
   void triggerHomeLimit() { _limitHomeFlag = true; }
 
+  // Called by the step timer ISR stubs in step_timer.cpp — must be public.
+  // Emits the pending pulse, loads its period into the timer, then computes the next one.
+  void onStepTimer();
+
 protected:
+  // Generator phase of the step being emitted. PHASE_LIMIT = emergency decel after a limit hit.
+  enum Phase : uint8_t { PHASE_IDLE, PHASE_ACCEL, PHASE_CRUISE, PHASE_DECEL, PHASE_LIMIT };
+
   uint8_t _id;
   bool    _hasLimits;
   int     _stepsPerRev;        // cached from driver->stepsPerRev() at init time
   int     _limitEndPin, _limitHomePin;   // -1 if unused (default for MotorBase)
   float   _mmPerRev, _maxRPS, _limitStopRevs;
-  long    _position;
-  float   _speedRPS;
+  float   _maxAccel;           // rev/s² ceiling for queued moves; 0 = none
+  bool    _softLimits;         // soft travel window [_softMin, _softMax] in force
+  long    _softMin, _softMax;
+  volatile long _position;
   bool    _movingForward;      // tracks current direction for limitTriggered()
   volatile bool _limitEndFlag, _limitHomeFlag;
 
@@ -53,15 +246,322 @@ protected:
   // Set direction on the driver and update _movingForward.
   void setDirection(bool forward);
 
+  // Blocking step loop used by waitDone() without a step timer. Default (nullptr): the loop
+  // over the StepperDriver interface. Motor<Driver> (motor.h) installs one bound to its
+  // concrete driver type.
+  typedef void (*StepLoop)(MotorBase& motor);
+  void setStepLoop(StepLoop loop) { _stepLoop = loop; }
+
+  // Steps per burst at periodUs: as many as fit in BURST_SPAN_US, 1 to STEP_BURST.
+  static uint8_t burstLength(unsigned long periodUs) {
+    unsigned long n = BURST_SPAN_US / periodUs;
+    return n < 1 ? 1 : (n > STEP_BURST ? STEP_BURST : (uint8_t)n);
+  }
+
+  // Drain the generator through driver.step(), and the cruise through driver.stepBurst().
+  // With a final driver type the driver calls are bound, and inlined, at compile time; with
+  // StepperDriver they are virtual. Group moves step one at a time for the follower hook,
+  // and every move does while a jitter probe is attached.
+  template <class Driver>
+  void runStepLoop(Driver& driver) {
+    unsigned long block[STEP_BURST];
+    while (_nextPeriodUs != 0) {
+      markPhase(_nextPhase);
+      if (_nextPhase == PHASE_CRUISE && !_group && !_jitter) {
+        uint8_t count = burstLength(_nextPeriodUs), n = 0;
+        while (n < count && _nextPeriodUs != 0 && _nextPhase == PHASE_CRUISE) {
+          block[n++]    = _nextPeriodUs;
+          _nextPeriodUs = nextStepPeriod();
+          _nextPhase    = _genPhase;
+        }
+        _periodUs = block[n - 1];
+        driver.stepBurst(block, n);
+        _position += (long)n * _dir;
+        continue;
+      }
+      _periodUs = _nextPeriodUs;
+      if (_jitter) _jitter->record(_nextPhase, _periodUs, micros());
+      if (_group) groupStep();
+      driver.step(_periodUs);
+      _position += _dir;
+      _nextPeriodUs = nextStepPeriod();
+      _nextPhase    = _genPhase;
+    }
+  }
+
 private:
+  // One constant-acceleration ramp: planned rate plus its index-1 period, T_1 = 1 / sqrt(2a).
+  struct RampRate {
+    Fixed         accel;       // rev/s²
+    unsigned long t1Q;         // Q20.12 µs; 0 = no ramp
+  };
+
+  // Generator constants of one trapezoid. entryN / exitN offset the ramp index so a segment
+  // can start and end at speed: accel starts from v = sqrt(2·a·entryN), decel ends at
+  // v = sqrt(2·a·exitN). planMove() builds one per move; MoveQueue builds them ahead of time,
+  // so a segment loads at a junction without 64-bit math.
+  struct Segment {
+    long          accelSteps, cruiseSteps, decelSteps;
+    long          entryN, exitN;
+    Fixed         cruiseRPS;
+    RampRate      accelRamp, decelRamp;
+    unsigned long cruiseQ, accelSeedQ, decelSeedQ;
+    int8_t        dir;
+  };
+
+  // Position-independent constants of a retarget, derived before interrupts go off.
+  struct ReplanRates {
+    RampRate      accelRamp, decelRamp;
+    Fixed         cruiseRPS;
+    unsigned long cruiseQ;
+    long          cruiseAccelN, cruiseDecelN;   // cruise speed as accel / decel ramp indices
+    Fixed         peakShare;                    // d / (a + d): accel share of a triangle
+  };
+
+  // ── Profile generator state (written by the ISR while a timed move runs) ──
+  volatile Phase _phase;       // phase currently being generated
+  Phase   _genPhase;           // phase of the step whose period nextStepPeriod() last returned
+  Phase   _limitHitPhase;      // phase in which a limit fired; PHASE_IDLE if none
+  int8_t  _dir;
+  long    _phaseStep;          // steps generated so far in _phase
+  long    _accelSteps, _cruiseSteps, _decelSteps, _limitSteps;
+  long    _entryN, _exitN;      // ramp index offsets of the current segment (0 = from / to rest)
+  Fixed   _cruiseRPS;
+  RampRate _accelRamp, _decelRamp, _limitRamp;
+  unsigned long _cruisePeriodUs;
+
+  // ── Resonance bands ──
+  // A ramp step whose period is inside a band strides _bandBoost ramp indices at once. In
+  // accel the skipped indices shorten the ramp and the steps saved are added to cruise; in
+  // decel they are paid back below the band by holding the period, so distance is exact.
+  SpeedBand     _bands[MAX_BANDS];
+  unsigned long _bandFastUs[MAX_BANDS], _bandSlowUs[MAX_BANDS];   // step periods at hi / lo
+  uint8_t       _bandCount, _bandBoost;
+  long          _bandSkip;     // ramp indices strided past the step count in this phase
+  unsigned long _rampUs;       // period of the last accel / decel step, for the band test
+
+  // ── Torque curve ──
+  // A curve move walks ramp steps counted from rest; each count maps to an index in the
+  // constant-accel ramp of its zone, whose rate is loaded into _curveRate.
+  TorqueCurve*       _torque;      // curve for curveMove(); nullptr = none
+  const TorqueCurve* _curveRun;    // _torque while a curveMove runs, else nullptr
+  uint8_t            _curveZone;   // zone of the last ramp step
+  RampRate           _curveRate;
+
+  // ── Austin ramp state — periods in Q20.12 µs ──
+  RampMode      _rampMode;
+  const uint16_t* _rampTable;  // PROGMEM periods while a tableTrapMove runs, else nullptr
+  unsigned long _rampQ;        // period of the last ramp step
+  unsigned long _rampRem;      // division remainder carried between recurrence steps
+  unsigned long _cruiseQ;      // accel floor: the recurrence never overshoots cruise speed
+  unsigned long _accelSeedQ;   // first accel period when the segment starts at speed
+  unsigned long _decelSeedQ, _limitSeedQ;   // first-step periods of the falling ramps
+  unsigned long _limitHitPeriodUs;          // step period when the limit fired
+  volatile unsigned long _periodUs;   // period of the last emitted step; 0 when stopped
+
+  // ── S-curve state — binary-scaled per-µs units so each step is integer-only ──
+  bool          _sCurve;       // accel/decel phases run the S-curve integrator
+  int8_t        _sSign;        // +1 accel half, -1 decel half
+  uint8_t       _sSeg;         // jerk segment of the current half: 0 = +j, 1 = 0, 2 = -j; 3 = done
+  int32_t       _sJerk;        // steps/µs³ · 2^64
+  int32_t       _sAccelMax;    // steps/µs² · 2^48
+  int32_t       _sAccel;       // current acceleration, steps/µs² · 2^48
+  uint32_t      _sSpeed;       // current speed, steps/µs · 2^32
+  uint32_t      _sSpeedTop, _sSpeedMin;   // peak speed; speed after the first step
+  unsigned long _sJerkUs, _sConstUs;      // segment lengths (µs)
+  unsigned long _sSegLeft, _sHalfLeft;    // µs left in the current segment / half
+  unsigned long _sFirstUs;     // first accel period: time to the first step from rest
+  unsigned long _sRem;         // remainder of 1 / v carried between steps
+  unsigned long _sPeriodUs;    // last decel period, held once the decel half has run out
+
+  // ── Coordinated move ──
+  MotionGroup* _group;         // group whose followers step with this axis (master); else nullptr
+  MoveQueue*   _queue;         // queue supplying the next segment at the end of decel; else nullptr
+  Segment       _chainSeg;     // retarget: segment that follows the current one
+  volatile bool _chainPending;
+  bool          _jog;          // velocity mode: cruise holds until the next replan
+
+  StepLoop     _stepLoop;      // bound blocking loop; nullptr = StepperDriver loop
+  StepJitter*  _jitter;        // per-step timing probe; nullptr = off
+
+  // ── Tach stall detection ──
+  // _tachBalance counts in 1 / (stepsPerRev · pulsesPerRev) rev: each step adds pulsesPerRev,
+  // each tach pulse subtracts stepsPerRev, so no divide runs per step.
+  int           _tachPin;      // -1 when no tach attached
+  uint16_t      _tachPPR;      // tach pulses per revolution
+  volatile uint8_t _tachPulses;   // ISR counter; 8 bits so the generator reads it atomically
+  uint8_t       _tachSeen;     // _tachPulses already accounted
+  long          _tachPos;      // _position already accounted
+  long          _tachBalance, _tachLagMax;
+  unsigned long _tachTotal;    // tach pulses counted in the current move
+  bool          _stalled;
+
+  // ── Step timer state ──
+  int8_t  _timerSlot;          // -1 when no timer attached
+  bool    _hwPulse;            // the timer makes the step edges (attachPulseTimer)
+  volatile bool  _busy;
+  unsigned long  _nextPeriodUs;   // precomputed period for the next ISR pulse; 0 = move done
+  Phase          _nextPhase;
+  unsigned long  _timerTicksLeft; // ticks still owed on a period longer than one timer interval
+
+  // ── Non-blocking move state ──
+  volatile bool    _doneEvent;      // set when a move finishes; cleared by completeMove()
+  bool             _reportPending;  // completeMove() prints the timing report
+  MoveDoneCallback _doneCallback;
+  unsigned long    _pollDueUs;      // micros() at which poll() emits the next step (no timer)
+  long             _moveStartPos, _moveTarget;   // for progress() and retargetSpeed()
+
+  // ── Phase timestamps for the timing report ──
+  uint8_t       _phaseMarked;     // bit per Phase already timestamped
+  unsigned long _phaseStartUs[PHASE_DECEL + 1];
+  unsigned long _moveEndUs;
+
+  // True when a move of steps (signed) from the current position ends inside the soft
+  // window, or there is none; otherwise prints fn's rejection and returns false.
+  bool softAllows(long steps, const char* fn) const;
+
+  // Jog distance in direction dir: unbounded (JOG_STEPS), or to the soft window's edge.
+  long jogSteps(int8_t dir) const;
+
+  // Pre-seed the flag for the limit in direction dir (no edge fires if already held LOW).
+  void seedLimitFlag(int8_t dir);
+
+  // Limit-decel rate (rev/s²) that stops the axis from _maxRPS within _limitStopRevs; 0 = none.
+  Fixed limitDecelRate() const;
+
+  // Set the limit-decel ramp (rev/s²); 0 makes a limit hit stop the axis at once.
+  void setLimitRate(Fixed accel);
+
+  // Account the steps and tach pulses since the last call; true once the tach lags too far.
+  bool tachStalled();
+
   // Direction-aware limit check using ISR-set flags.
   // Returns false when _hasLimits = false or when moving away from the triggered limit.
-  bool limitTriggered();
+  // Inline: it runs once per step in the generator.
+  bool limitTriggered() {
+    if (!_hasLimits) return false;
+    return _movingForward ? _limitEndFlag : _limitHomeFlag;
+  }
+
+  // Switch the generator into an emergency decel from the current speed,
+  // using the fixed decel rate in _limitRamp (derived from _maxRPS in planMove).
+  void beginLimitDecel();
+
+  // Period (µs) for ramp index n in float: v = sqrt(2 * a * n). RAMP_SQRT only.
+  unsigned long rampPeriod(const RampRate& ramp, long n);
+
+  // Next ramp period (µs) while the index rises (accel) or falls (decel / limit decel).
+  // first marks the first step of a ramp, which takes seedQ instead of a recurrence step
+  // (rising ramps only need it when they start at speed). stride is the number of indices
+  // since the last step (more than 1 inside a resonance band).
+  unsigned long rampUp(const RampRate& ramp, long n, unsigned long seedQ, bool first,
+                       uint8_t stride = 1);
+  unsigned long rampDown(const RampRate& ramp, long n, unsigned long seedQ, bool first,
+                         uint8_t stride = 1);
+
+  // safeSpeed() for a move's cruise request, with a Serial note when it was moved.
+  float snapCruise(float rps) const;
+
+  // Ramp indices the next step may stride: the band boost while the last ramp period is in
+  // a resonance band, at most limit; else 1.
+  uint8_t bandStride(long limit) const;
+
+  // Torque curve, planning: ramp steps from rest to rps, the zone holding ramp step count
+  // (1-based, from rest), the speed there and the ramp time from rest to rps (s).
+  long    curveSteps(Fixed rps) const;
+  uint8_t curveZoneOf(long count) const;
+  Fixed   curveSpeedAt(long count) const;
+  float   curveTime(float rps) const;
+
+  // Torque curve, generator: move _curveZone to the zone of ramp step count (1-based, from
+  // rest), load its rate into _curveRate and return the step's index in that zone's ramp;
+  // edge reads true when the zone changed. curveUp() / curveDown() are rampUp() / rampDown()
+  // on it, reseeding the period exactly at a zone edge.
+  long          curveIndex(long count, bool& edge);
+  unsigned long curveUp(long count, bool first, uint8_t stride);
+  unsigned long curveDown(long count, bool first, uint8_t stride);
+
+  // S-curve generator: reset the integrator to the start of the accel (+1) or decel (-1) half.
+  void sCurveBegin(int8_t sign);
+
+  // Integrate the S-curve kinematics over dt µs, crossing jerk segments as needed.
+  void sCurveAdvance(unsigned long dt);
+
+  // Period (µs) of the next S-curve step from the current speed and acceleration.
+  unsigned long sCurvePeriod();
+
+  // Next accel / decel period of an S-curve move. sCurveUp() returns 0 once the accel half
+  // is complete, which hands over to cruise; last marks the final decel step.
+  unsigned long sCurveUp();
+  unsigned long sCurveDown(bool first, bool last);
+
+  // Period (µs) of the next step, advancing through the planned phases. 0 = move finished.
+  unsigned long nextStepPeriod();
+
+  // Derive the generator constants of a trapezoid. cruiseRPS in rev/s, accel/decel in rev/s²;
+  // entryN / exitN are the ramp indices of the entry and exit speeds (0 = rest).
+  void planSegment(Segment& seg, long aSteps, long cSteps, long dSteps,
+                   Fixed cruiseRPS, Fixed accel, Fixed decel, int8_t dir,
+                   long entryN = 0, long exitN = 0) const;
+
+  // Make seg the generator's current segment, starting at its accel phase.
+  void loadSegment(const Segment& seg);
+
+  // loadSegment() at a segment junction: switches direction and re-seeds the limit flag first
+  // when seg reverses (possibly in the step timer ISR).
+  void chainSegment(const Segment& seg);
+
+  // Replan the running move toward an absolute step target at cruiseRPS (0 = stop), with
+  // new ramp rates; jog makes the cruise hold. replanFrom() is the interrupts-off part.
+  bool replan(long target, float cruiseRPS, Fixed accel, Fixed decel, bool jog);
+  bool replanFrom(long target, const ReplanRates& r, bool jog);
+  void replanRates(ReplanRates& r, float cruiseRPS, Fixed accel, Fixed decel) const;
+
+  // Build a retarget segment from the current ramps (see motor_base.cpp).
+  void replanSegment(Segment& seg, long steps, long entryN, int8_t dir,
+                     const ReplanRates& r, long exitN = -1) const;
+
+  // Load a planned move into the generator and pre-seed the limit flags.
+  // cruiseRPS in rev/s, accel/decel in rev/s².
+  void planMove(long aSteps, long cSteps, long dSteps,
+                Fixed cruiseRPS, Fixed accel, Fixed decel, int8_t dir);
+
+  // Start a move at seg: limit flags, limit-decel rate and generator state for a fresh move.
+  void beginMove(const Segment& seg);
+
+  // Start draining the generator: through the step timer when attached, else from poll()
+  // or waitDone(). report queues the timing report for completeMove().
+  void startRun(bool report = false);
+
+  // Start the generator and block until it is drained.
+  void runMove();
+
+  // Emit the pending pulse, then precompute the following period (timer ISR and poll()).
+  void emitStep();
+
+  // Deliver the completion event of a finished move: report, then the done callback.
+  void completeMove();
+
+  // Record the time the first step of phase p is emitted. Runs once per step.
+  void markPhase(Phase p) {
+    if (p > PHASE_DECEL || (_phaseMarked & (1 << p))) return;
+    _phaseMarked |= (1 << p);
+    _phaseStartUs[p] = micros();
+  }
+
+  // Follower steps of the MotionGroup this axis is master of.
+  void groupStep();
+
+  // Timestamp of the first step of phase p, or fallback when the phase was empty.
+  unsigned long phaseStartUs(Phase p, unsigned long fallback) const;
+
+  // Mark the move as finished and record its end time.
+  void finishMove();
 
-  // Emergency decel to a stop using a fixed decel rate derived from _maxRPS.
-  void runLimitDecel(float currentSpeedStepsPerSec, int8_t dir);
+  // Serial report: limit and stall events and expected vs actual phase times.
+  void reportMove();
 
-  // Core 3-phase step executor: accel → cruise → decel.
-  void runTrapezoid(int aSteps, int cSteps, int dSteps,
-                    float cruiseSpeed, float accelRate, float decelRate, int8_t dir);
+  // Core 3-phase step executor: accel → cruise → decel. Starts the move with its report queued.
+  void startTrapezoid(long aSteps, long cSteps, long dSteps,
+                      Fixed cruiseRPS, Fixed accel, Fixed decel, int8_t dir);
 };
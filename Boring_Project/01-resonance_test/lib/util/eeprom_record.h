@@ -0,0 +1,40 @@
+// eeprom_record.h
+// Versioned, CRC-checked blocks in the AVR's EEPROM, for data that must survive a power
+// cycle (LinearMotor calibration and tuning). A record at addr is laid out as
+//   'M' 'B'  version  size  data[size]  crc16 (lo, hi)
+// with the CRC-16/CCITT (0x1021, init 0xFFFF) over everything before it. A record reads back
+// only when magic, version, size and CRC all match, so a blank chip, a record written by an
+// older layout or a write cut short by a reset reads as missing, never as data.
+//
+// Writes go through EEPROM.update(): bytes that did not change are not rewritten, so saving
+// the same calibration again costs no EEPROM wear (~100k writes per cell).
+//
+// Usage:
+//   EepromRecord::write(0, 1, &rec, sizeof(rec));         // addr, version, data, size
+//   if (!EepromRecord::read(0, 1, &rec, sizeof(rec))) ... // missing, old or corrupt
+
+#pragma once
+
+#include <Arduino.h>
+
+namespace EepromRecord {
+
+  static const uint8_t OVERHEAD = 6;   // bytes around the data: magic, version, size, CRC
+
+  // EEPROM bytes a record of size data bytes takes; place the next record that far on.
+  inline int span(uint8_t size) { return size + OVERHEAD; }
+
+  // Store size bytes of data at addr. Returns false when the record would not fit.
+  bool write(int addr, uint8_t version, const void* data, uint8_t size);
+
+  // Load the record at addr into data. Returns false, leaving data untouched and printing
+  // why, when there is no valid record of this version and size.
+  bool read(int addr, uint8_t version, void* data, uint8_t size);
+
+  // Invalidate the record at addr (its magic), so the next read() fails.
+  void erase(int addr);
+
+  // One byte of CRC-16/CCITT.
+  uint16_t crc16(uint16_t crc, uint8_t byte);
+
+} // namespace EepromRecord
@@ -0,0 +1,109 @@
+// fixed.h
+// Q16.16 signed fixed-point number for motion planning on AVR (no FPU).
+// Range ±32767.99998, resolution 1/65536 (≈1.5e-5). Add, subtract and compare are single
+// 32-bit integer ops; multiply and divide go through a 64-bit intermediate and belong in
+// per-move planning, not per-step work.
+//
+// Usage:  Fixed rps = Fixed::fromFloat(10.0f);
+//         long  steps = Fixed::fromFloat(2.5f).mulInt(stepsPerRev);   // revs → steps
+
+#pragma once
+
+#include <Arduino.h>
+
+// Integer square root: floor(sqrt(x)). Bitwise, no division. The 32-bit form is cheap
+// enough for an ISR (16 rounds of shift/compare); the 64-bit form is for planning.
+inline uint16_t isqrt32(uint32_t x) {
+  uint32_t res = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > x) bit >>= 2;
+  while (bit != 0) {
+    if (x >= res + bit) {
+      x   -= res + bit;
+      res  = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)res;
+}
+
+inline uint32_t isqrt64(uint64_t x) {
+  uint64_t res = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > x) bit >>= 2;
+  while (bit != 0) {
+    if (x >= res + bit) {
+      x   -= res + bit;
+      res  = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)res;
+}
+
+class Fixed {
+public:
+  static const uint8_t FRAC_BITS = 16;
+  static const int32_t ONE       = 1L << FRAC_BITS;
+
+  constexpr Fixed() : _raw(0) {}
+
+  static constexpr Fixed fromRaw(int32_t raw) { return Fixed(raw, 0); }
+  static constexpr Fixed fromInt(int32_t v)   { return Fixed(v * ONE, 0); }
+  static constexpr Fixed fromFloat(float v) {
+    return Fixed((int32_t)(v * ONE + (v >= 0.0f ? 0.5f : -0.5f)), 0);
+  }
+
+  // num / den as Q16.16 — e.g. Fixed::ratio(steps, stepsPerRev) for revolutions.
+  static Fixed ratio(int32_t num, int32_t den) {
+    return fromRaw((int32_t)(((int64_t)num << FRAC_BITS) / den));
+  }
+
+  constexpr int32_t raw()     const { return _raw; }
+  constexpr float   toFloat() const { return (float)_raw / ONE; }
+  constexpr int32_t floor()   const { return _raw >> FRAC_BITS; }
+  constexpr int32_t round()   const { return (_raw + ONE / 2) >> FRAC_BITS; }
+
+  // this × k rounded to the nearest integer (revs × stepsPerRev → steps). Rounding, not
+  // truncation: 0.7 is stored as 0.699997, and 0.7 rev × 200 must still give 140 steps.
+  int32_t mulInt(int32_t k) const {
+    int64_t p    = (int64_t)_raw * k;
+    int64_t half = (int64_t)ONE / 2;
+    return (int32_t)(p < 0 ? -((-p + half) >> FRAC_BITS) : ((p + half) >> FRAC_BITS));
+  }
+
+  constexpr Fixed operator+(Fixed o)   const { return Fixed(_raw + o._raw, 0); }
+  constexpr Fixed operator-(Fixed o)   const { return Fixed(_raw - o._raw, 0); }
+  constexpr Fixed operator-()          const { return Fixed(-_raw, 0); }
+  constexpr Fixed operator*(int32_t k) const { return Fixed(_raw * k, 0); }
+  constexpr Fixed operator/(int32_t k) const { return Fixed(_raw / k, 0); }
+
+  Fixed operator*(Fixed o) const {
+    return fromRaw((int32_t)(((int64_t)_raw * o._raw) >> FRAC_BITS));
+  }
+  Fixed operator/(Fixed o) const {
+    return fromRaw((int32_t)(((int64_t)_raw << FRAC_BITS) / o._raw));
+  }
+
+  constexpr bool operator< (Fixed o) const { return _raw <  o._raw; }
+  constexpr bool operator<=(Fixed o) const { return _raw <= o._raw; }
+  constexpr bool operator> (Fixed o) const { return _raw >  o._raw; }
+  constexpr bool operator>=(Fixed o) const { return _raw >= o._raw; }
+  constexpr bool operator==(Fixed o) const { return _raw == o._raw; }
+  constexpr bool operator!=(Fixed o) const { return _raw != o._raw; }
+
+  constexpr Fixed abs() const { return Fixed(_raw < 0 ? -_raw : _raw, 0); }
+
+  // sqrt(raw / 2^16) · 2^16 = sqrt(raw · 2^16). Negative input returns 0.
+  Fixed sqrt() const {
+    return fromRaw(_raw <= 0 ? 0 : (int32_t)isqrt64((uint64_t)_raw << FRAC_BITS));
+  }
+
+private:
+  constexpr Fixed(int32_t raw, int) : _raw(raw) {}
+  int32_t _raw;
+};
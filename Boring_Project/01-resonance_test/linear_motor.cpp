@@ -3,6 +3,7 @@
 
 #include "lib/motor/linear_motor.h"
 #include "lib/control/display/display.h"
+#include "lib/util/eeprom_record.h"
 
 // ── ISR slot table ────────────────────────────────────────────────────────────
 // Stores up to 4 LinearMotor pointers. Each slot owns one end-ISR and one home-ISR stub.
@@ -40,6 +41,14 @@ void LinearMotor::init(uint8_t id, StepperDriver* driver,
   _maxRPS       = maxRPS;
   _endPos       = 0;
   _axisLength   = 0;
+  _trialRevs    = 5.0f;
+  _trialTol     = _stepsPerRev / 50;
+  _trialHomeRPS = 0.5f;
+  _accelLimit   = 0.0f;
+  _speedLimit   = 0.0f;
+  _homeFastRPS  = 0.0f;
+  _homeAccel    = 0.0f;
+  _softMargin   = -1;
 
   if (limitEndPin  >= 0) pinMode(limitEndPin,  INPUT_PULLUP);
   if (limitHomePin >= 0) pinMode(limitHomePin, INPUT_PULLUP);
@@ -84,41 +93,60 @@ bool LinearMotor::atHome() const { return _limitHomePin >= 0 && digitalRead(_lim
 
 // ── Private creep helpers ─────────────────────────────────────────────────────
 
+// Skipped with the sensor already active — the caller's "already on it" path handles that.
+// A stop with the sensor clear (a flag narrower than the limit decel overrun, or a stall)
+// returns false, and the caller creeps the rest.
+bool LinearMotor::fastApproach(int sensorPin, int8_t dir) {
+  if (_homeFastRPS <= 0.0f || digitalRead(sensorPin) == LOW) return false;
+  bool soft   = _softLimits;                  // the sensors lie outside the soft window
+  _softLimits = false;
+  bool moved  = setTargetVelocity(dir * _homeFastRPS, _homeAccel);
+  waitDone();
+  _softLimits = soft;
+  return moved && digitalRead(sensorPin) == LOW;
+}
+
 void LinearMotor::creepUntilSensor(int sensorPin, int8_t dir, float rps) {
-  unsigned long stepPeriod = (unsigned long)(1000000.0 / (rps * _stepsPerRev));
-  while (digitalRead(sensorPin) == HIGH) {
-    _driver->step(stepPeriod);
-    _position += dir;
-  }
+  creepWhile(sensorPin, HIGH, dir, rps);
 }
 
 void LinearMotor::creepUntilSensorClear(int sensorPin, int8_t dir, float rps) {
+  creepWhile(sensorPin, LOW, dir, rps);
+}
+
+void LinearMotor::creepWhile(int sensorPin, int level, int8_t dir, float rps) {
   unsigned long stepPeriod = (unsigned long)(1000000.0 / (rps * _stepsPerRev));
-  while (digitalRead(sensorPin) == LOW) {
-    _driver->step(stepPeriod);
-    _position += dir;
+  unsigned long block[STEP_BURST];
+  uint8_t count = burstLength(stepPeriod);
+  for (uint8_t i = 0; i < count; i++) block[i] = stepPeriod;
+
+  while (digitalRead(sensorPin) == level) {
+    _driver->stepBurst(block, count);
+    _position += (long)count * dir;
   }
 }
 
 // ── Calibration ───────────────────────────────────────────────────────────────
 
-void LinearMotor::findHome(float slowRPS) {
+long LinearMotor::findHome(float slowRPS) {
   Serial.print("--- Motor "); Serial.print(_id); Serial.println(" Homing ---");
 
-  if (digitalRead(_limitHomePin) == LOW) {
+  if (fastApproach(_limitHomePin, -1)) {
+    Serial.println("Home sensor reached at speed — backing off until clear.");
+  } else if (digitalRead(_limitHomePin) == LOW) {
     Serial.println("Already on home sensor — backing off until clear.");
-    setDirection(true);  // toward end = away from home
-    creepUntilSensorClear(_limitHomePin, 1, slowRPS);
   } else {
     setDirection(false);  // toward home
     creepUntilSensor(_limitHomePin, -1, slowRPS);
     Serial.println("Home sensor detected — backing off until clear.");
-    setDirection(true);   // away from home
-    creepUntilSensorClear(_limitHomePin, 1, slowRPS);
   }
+  setDirection(true);     // toward end = away from home
+  creepUntilSensorClear(_limitHomePin, 1, slowRPS);
+  long lost = _position;
   _position = 0;
-  Serial.println("Home set. Position = 0.");
+  Serial.print("Home set. Position = 0 (was "); Serial.print(lost); Serial.println(").");
   Display::renderMotorInfo(*this);
+  return lost;
 }
 
 void LinearMotor::findEnd(float slowRPS) {
@@ -128,19 +156,35 @@ void LinearMotor::findEnd(float slowRPS) {
     Serial.println("Already at end.");
     _endPos     = _position;
     _axisLength = _endPos;
+    applySoftLimits();
     Display::renderMotorInfo(*this);
     return;
   }
-  setDirection(true);  // toward end
+  if (fastApproach(_limitEndPin, 1)) {
+    Serial.println("End sensor reached at speed — backing off to re-approach slowly.");
+    setDirection(false);  // toward home
+    creepUntilSensorClear(_limitEndPin, -1, slowRPS);
+  }
+  setDirection(true);     // toward end
   creepUntilSensor(_limitEndPin, 1, slowRPS);
   _endPos     = _position;
   _axisLength = _endPos;
+  applySoftLimits();
   Serial.print("End found at "); Serial.print(_endPos);
   Serial.print(" steps ("); Serial.print((float)_axisLength / _stepsPerRev, 3);
   Serial.println(" revs)");
   Display::renderMotorInfo(*this);
 }
 
+void LinearMotor::setHomingSpeed(float fastRPS, float accel) {
+  if (fastRPS != 0.0f && accel == 0.0f) {
+    Serial.println("LinearMotor::setHomingSpeed: accel must be non-zero.");
+    return;
+  }
+  _homeFastRPS = fabs(fastRPS);
+  _homeAccel   = fabs(accel);
+}
+
 void LinearMotor::calibrate(float slowRPS) {
   findHome(slowRPS);
   findEnd(slowRPS);
@@ -164,9 +208,208 @@ void LinearMotor::goHome(float cruiseRPS) {
 }
 
 void LinearMotor::goToEnd(float cruiseRPS) {
-  float totalRevs = (float)(_endPos - _position) / _stepsPerRev;
+  long  target    = _softLimits ? min(_endPos, _softMax) : _endPos;
+  float totalRevs = (float)(target - _position) / _stepsPerRev;
   if (abs(totalRevs) < 0.01f) { Serial.println("Already at end."); return; }
   float ramp   = min(2.0f, abs(totalRevs) / 3.0f);
   float cruise = abs(totalRevs) - 2.0f * ramp;
   manualTrapMove(ramp, cruise, ramp, cruiseRPS);
 }
+
+// ── Soft limits ───────────────────────────────────────────────────────────────
+
+void LinearMotor::enableSoftLimits(float marginRevs) {
+  _softMargin = max(1L, Fixed::fromFloat(fabs(marginRevs)).mulInt(_stepsPerRev));
+  if (_axisLength <= 0) {
+    Serial.println("LinearMotor::enableSoftLimits: no axis length yet — applied after findEnd().");
+    return;
+  }
+  applySoftLimits();
+}
+
+void LinearMotor::disableSoftLimits() {
+  _softMargin = -1;
+  clearSoftLimits();
+}
+
+// The end margin is at least one step: endPos itself is on the sensor.
+void LinearMotor::applySoftLimits() {
+  if (_softMargin < 0 || _endPos <= 0) return;
+  setSoftLimits(0, max(0L, _endPos - _softMargin));
+  Serial.print("Motor "); Serial.print(_id); Serial.print(": soft limits 0..");
+  Serial.print(_softMax); Serial.println(" steps");
+}
+
+// ── Stall-threshold search ────────────────────────────────────────────────────
+
+void LinearMotor::setStallTrial(float travelRevs, long tolSteps, float homeRPS) {
+  _trialRevs    = fabs(travelRevs);
+  _trialTol     = labs(tolSteps);
+  _trialHomeRPS = fabs(homeRPS);
+}
+
+// A move cut short skips the way back. The re-home needs no position: it runs to the home
+// sensor (fast approach with setHomingSpeed(), creeping otherwise, or when the approach is
+// itself stopped short), so any steps lost show up as its error.
+LinearMotor::TrialResult LinearMotor::stallTrial(float accel, float cruiseRPS, long* errSteps) {
+  if (errSteps) *errSteps = 0;
+  float rps    = fabs(cruiseRPS);
+  float ramp   = (accel > 0.0f) ? rps * rps / (2.0f * accel) : 0.0f;
+  float cruise = _trialRevs - 2.0f * ramp;
+  if (ramp <= 0.0f || cruise < 0.0f) {
+    Serial.println("LinearMotor::stallTrial: travel too short for both ramps.");
+    return TRIAL_SKIPPED;
+  }
+
+  bool soft   = _softLimits;                  // the trial's travel is its own
+  _softLimits = false;
+  manualTrapMove(ramp, cruise, ramp, rps);
+  if (!stoppedEarly()) manualTrapMove(-ramp, -cruise, -ramp, rps);
+  _softLimits = soft;
+  TrialResult result = stalled() ? TRIAL_STALL : stoppedEarly() ? TRIAL_LIMIT : TRIAL_PASS;
+
+  long err = findHome(_trialHomeRPS);
+  if (errSteps) *errSteps = err;
+  if (result == TRIAL_PASS && labs(err) > _trialTol) result = TRIAL_LOST;
+  return result;
+}
+
+LinearMotor::StallLimit LinearMotor::findAccelLimit(float lo, float hi, float cruiseRPS,
+                                                    float resolution) {
+  return stallSearch(false, lo, hi, cruiseRPS, resolution);
+}
+
+LinearMotor::StallLimit LinearMotor::findSpeedLimit(float lo, float hi, float accel,
+                                                    float resolution) {
+  return stallSearch(true, lo, hi, accel, resolution);
+}
+
+// The trials' own move reports go to Serial as they run; the search table is held back and
+// printed in one block at the end.
+LinearMotor::StallLimit LinearMotor::stallSearch(bool speed, float lo, float hi, float other,
+                                                 float resolution) {
+  static const char* const RESULTS[] = {"pass", "lost", "limit", "stall", "skipped"};
+  StallLimit r = {0.0f, 0.0f, 0};
+
+  if (lo <= 0.0f || hi <= lo || other <= 0.0f || resolution <= 0.0f) {
+    Serial.println("LinearMotor::stallSearch: needs 0 < lo < hi and positive levels.");
+    return r;
+  }
+  // Longest ramp of the search: the highest speed, or the lowest accel.
+  float rampRevs = speed ? hi * hi / (2.0f * other) : other * other / (2.0f * lo);
+  if (2.0f * rampRevs > _trialRevs) {
+    Serial.println("LinearMotor::stallSearch: travel too short for the longest ramp.");
+    return r;
+  }
+  if (_axisLength > 0 && _trialRevs * _stepsPerRev > _axisLength) {
+    Serial.println("LinearMotor::stallSearch: travel longer than the axis.");
+    return r;
+  }
+
+  float   levels[STALL_MAX_RUNS];
+  long    errs[STALL_MAX_RUNS];
+  uint8_t results[STALL_MAX_RUNS];
+
+  findHome(_trialHomeRPS);
+  while (r.runs < STALL_MAX_RUNS) {
+    float level = (r.runs == 0) ? hi : (r.runs == 1) ? lo : (r.passLevel + r.failLevel) / 2.0f;
+    long        err;
+    TrialResult res = speed ? stallTrial(other, level, &err) : stallTrial(level, other, &err);
+    bool        ok  = (res == TRIAL_PASS);
+
+    levels[r.runs]  = level;
+    errs[r.runs]    = err;
+    results[r.runs] = res;
+    if (ok) r.passLevel = level;
+    else    r.failLevel = level;
+    r.runs++;
+
+    if (r.runs == 1 && ok)  break;                   // hi passed: no limit in range
+    if (r.runs == 2 && !ok) break;                   // lo failed as well
+    if (r.runs >= 2 && r.failLevel - r.passLevel <= resolution) break;
+  }
+
+  const char* unit = speed ? " RPS" : " rev/s²";
+  Serial.print("--- Motor "); Serial.print(_id);
+  Serial.println(speed ? " Speed Stall Search ---" : " Accel Stall Search ---");
+  Serial.print(speed ? "Accel=" : "Cruise="); Serial.print(other, 2);
+  Serial.print(speed ? " rev/s²" : " RPS");
+  Serial.print(", Travel="); Serial.print(_trialRevs, 2);
+  Serial.print(" rev, Tolerance="); Serial.print(_trialTol); Serial.println(" steps");
+  Serial.println(speed ? "run,rps,error_steps,result" : "run,accel,error_steps,result");
+  for (uint8_t i = 0; i < r.runs; i++) {
+    Serial.print(i + 1);          Serial.print(",");
+    Serial.print(levels[i], 2);   Serial.print(",");
+    Serial.print(errs[i]);        Serial.print(",");
+    Serial.println(RESULTS[results[i]]);
+  }
+  Serial.print("Limit: ");
+  if (r.failLevel == 0.0f) {
+    Serial.print("no stall up to "); Serial.print(hi, 2); Serial.print(unit);
+  } else if (r.passLevel == 0.0f) {
+    Serial.print("stalls at "); Serial.print(lo, 2); Serial.print(unit); Serial.print(" already");
+  } else {
+    Serial.print("passes "); Serial.print(r.passLevel, 2); Serial.print(unit);
+    Serial.print(", fails "); Serial.print(r.failLevel, 2); Serial.print(unit);
+  }
+  Serial.print(" ("); Serial.print(r.runs); Serial.println(" runs)");
+  (speed ? _speedLimit : _accelLimit) = r.passLevel;
+  return r;
+}
+
+// ── Calibration store ─────────────────────────────────────────────────────────
+
+int LinearMotor::calibrationSpan() {
+  return EepromRecord::span(sizeof(CalibRecord));
+}
+
+bool LinearMotor::saveCalibration(int addr) {
+  CalibRecord rec;
+  memset(&rec, 0, sizeof(rec));                 // padding too, so equal records write nothing
+  rec.stepsPerRev   = _stepsPerRev;
+  rec.endPos        = _endPos;
+  rec.axisLength    = _axisLength;
+  rec.accelLimit    = _accelLimit;
+  rec.speedLimit    = _speedLimit;
+  rec.maxAccel      = _maxAccel;
+  rec.limitStopRevs = _limitStopRevs;
+  rec.bandCount     = resonanceBands(rec.bands, &rec.bandBoost);
+  if (!EepromRecord::write(addr, CALIB_VERSION, &rec, sizeof(rec))) return false;
+  Serial.print("Motor "); Serial.print(_id); Serial.print(": calibration saved at EEPROM ");
+  Serial.println(addr);
+  return true;
+}
+
+bool LinearMotor::loadCalibration(int addr) {
+  CalibRecord rec;
+  if (!EepromRecord::read(addr, CALIB_VERSION, &rec, sizeof(rec))) return false;
+  if (rec.stepsPerRev != (uint16_t)_stepsPerRev) {
+    Serial.print("LinearMotor::loadCalibration: record is for "); Serial.print(rec.stepsPerRev);
+    Serial.println(" steps/rev — recalibrate.");
+    return false;
+  }
+  if (!setResonanceBands(rec.bands, rec.bandCount, rec.bandBoost)) return false;
+  _endPos        = rec.endPos;
+  _axisLength    = rec.axisLength;
+  _accelLimit    = rec.accelLimit;
+  _speedLimit    = rec.speedLimit;
+  _maxAccel      = rec.maxAccel;
+  _limitStopRevs = rec.limitStopRevs;
+
+  Serial.print("--- Motor "); Serial.print(_id); Serial.println(" Calibration Restored ---");
+  Serial.print("Axis (steps): "); Serial.print(_axisLength); Serial.print(" steps | ");
+  Serial.print(axisLengthRevs(), 3); Serial.print(" revs, ");
+  Serial.print(rec.bandCount); Serial.println(" resonance bands");
+  applySoftLimits();
+  return true;
+}
+
+bool LinearMotor::bootCalibrate(int addr, float slowRPS) {
+  if (loadCalibration(addr)) {
+    findHome(slowRPS);
+    return true;
+  }
+  calibrate(slowRPS);
+  saveCalibration(addr);
+  return false;
+}
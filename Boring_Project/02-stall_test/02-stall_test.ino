@@ -1,5 +1,10 @@
 // Stall Test — STR3 Stepper on THK KR33
-// X-Axis (STR3): Dir=D9, Step=D10, Limits=D2(End)/D3(Home)
+// X-Axis (STR3): Dir=D9, Step=D10, Limits=D2(End)/D3(Home), Tach Out=D18
+// One button press runs two bisection searches with no operator: the accel limit at
+// CRUISE_RPS, then the speed limit at SPEED_ACCEL. Each trial runs out and back, re-homes
+// from the sensor and fails on lost steps, a limit trip or a tach stall (see
+// LinearMotor::findAccelLimit). Each search prints a CSV table and the bracket it converged to;
+// the pass levels are saved with the axis calibration in EEPROM (CALIB_ADDR).
 // Button: D22 | LCD: RS=7, EN=8, D4=4, D5=5, D6=6, D7=11
 
 #include <LiquidCrystal.h>
@@ -8,17 +13,34 @@
 #include "lib/driver/lcd/lcd.h"
 #include "lib/util/fstr.h"
 
+// ── CONFIGURATION ──────────────────────────────────────────────────────────────
+const int      BUTTON_PIN    = 22;
+const int      TACH_PIN      = 18;     // interrupt pin
+const uint16_t TACH_PPR      = 100;    // pulses per rev, as set on the driver
+const float    TACH_LAG_REVS = 0.25f;  // stall once the tach trails the steps by this much
+
+const float TRAVEL_REVS  = 8.0f;       // out-and-back distance of every trial
+const long  TOL_STEPS    = 4;          // re-home error that still passes
+const float HOME_RPS     = 0.5f;
+const float HOMING_RPS   = 5.0f;       // re-home approach, well inside the limits under test
+const float HOMING_ACCEL = 20.0f;
+const int   CALIB_ADDR   = 0;          // EEPROM record of the X axis, shared with 99-main-program
+
+const float CRUISE_RPS   = 10.0f;      // accel search: fixed cruise, accel bracket (rev/s²)
+const float ACCEL_LO     = 20.0f;
+const float ACCEL_HI     = 1000.0f;
+const float ACCEL_RES    = 10.0f;
+
+const float SPEED_ACCEL  = 50.0f;      // speed search: fixed accel, speed bracket (rev/s)
+const float SPEED_LO     = 2.0f;
+const float SPEED_HI     = 15.0f;
+const float SPEED_RES    = 0.25f;
+// ──────────────────────────────────────────────────────────────────────────────
+
 LiquidCrystal lcd(7, 8, 4, 5, 6, 11);  // RS, EN, D4, D5, D6, D7
 STR3        xDriver(9, 10, 200);        // dirPin, stepPin, stepsPerRev
 LinearMotor motor;
 
-const int   BUTTON_PIN  = 22;
-const float CRUISE_RPS  = 10.0f;
-const float CRUISE_REVS = 5.0f;
-
-float ramps[]  = { 3.0, 2.0, 1.5, 1.0, 0.75, 0.5, 0.35, 0.25, 0.15, 0.10, 0.05 };
-int   numTests = sizeof(ramps) / sizeof(ramps[0]);
-
 void waitForButtonPress() {
   while (digitalRead(BUTTON_PIN) == LOW)  delay(10);
   while (digitalRead(BUTTON_PIN) == HIGH) delay(10);
@@ -26,12 +48,25 @@ void waitForButtonPress() {
   delay(50);
 }
 
+// "<label> <pass>/<fail>" on the current LCD row; a dash for an open end of the bracket.
+void showLimit(const char* label, const LinearMotor::StallLimit& r, int decimals) {
+  char pass[12], fail[12];  // fstr() has one static buffer: copy each value out
+  snprintf(pass, sizeof(pass), "%s", r.passLevel > 0.0f ? fstr(r.passLevel, decimals) : "-");
+  snprintf(fail, sizeof(fail), "%s", r.failLevel > 0.0f ? fstr(r.failLevel, decimals) : "-");
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%s %s/%s", label, pass, fail);
+  LCD::print(buf);
+}
+
 void setup() {
   Serial.begin(115200);
   pinMode(BUTTON_PIN, INPUT);
 
   motor.init(1, &xDriver, 2, 3, 6.0f, 15.0f);  // id, driver, limitEndPin, limitHomePin, mmPerRev, maxRPS
   motor.enableLimits();
+  motor.attachTach(TACH_PIN, TACH_PPR, TACH_LAG_REVS);  // pin, pulsesPerRev, maxLagRevs
+  motor.setStallTrial(TRAVEL_REVS, TOL_STEPS, HOME_RPS); // travelRevs, tolSteps, homeRPS
+  motor.setHomingSpeed(HOMING_RPS, HOMING_ACCEL);         // fastRPS, accel — latch stays at HOME_RPS
 
   LCD::init(&lcd, 16, 2);  // lcd, cols, rows
   LCD::clear();
@@ -39,11 +74,10 @@ void setup() {
   LCD::setCursor(0, 1);  // col, row
   LCD::print("Calibrating...");
 
-  motor.calibrate(0.5f);   // slowRPS
+  motor.bootCalibrate(CALIB_ADDR, 0.5f);   // eepromAddr, slowRPS — full calibrate only without a record
   motor.goHome(2.0f);      // cruiseRPS
 
   Serial.println("=== STALL TEST READY ===");
-  Serial.print("Cruise: "); Serial.print(CRUISE_RPS); Serial.println(" RPS");
   LCD::clear();
   LCD::print("Press to begin");
 }
@@ -52,38 +86,18 @@ void loop() {
   waitForButtonPress();
   Serial.println("=== STALL TEST START ===\n");
 
-  for (int i = 0; i < numTests; i++) {
-    float ramp       = ramps[i];
-    float accelRevS2 = (CRUISE_RPS * CRUISE_RPS) / (2.0f * ramp);
-
-    Serial.print("["); Serial.print(i + 1); Serial.print("/"); Serial.print(numTests); Serial.print("]  ");
-    Serial.print("Ramp="); Serial.print(ramp, 2); Serial.print(" rev    ");
-    Serial.print("Accel="); Serial.print(accelRevS2, 1); Serial.println(" rev/s²");
-
-    LCD::clear();
-    char buf[17];
-    snprintf(buf, sizeof(buf), "Level %d/%d", i + 1, numTests);
-    LCD::print(buf);
-    LCD::setCursor(0, 1);  // col, row
-    snprintf(buf, sizeof(buf), "%s rev/s^2", fstr(accelRevS2, 0));  // fstr: val, decimals
-    LCD::print(buf);
-
-    motor.manualTrapMove(ramp, CRUISE_REVS, ramp, CRUISE_RPS);  // accelRevs, cruiseRevs, decelRevs, cruiseRPS
-    delay(300);
-    motor.goHome(2.0f);  // cruiseRPS
-    delay(300);
-
-    if (i < numTests - 1) {
-      Serial.println("  >> Press for next level\n");
-      LCD::clear();
-      LCD::print("Press for next");
-      waitForButtonPress();
-    }
-  }
+  LCD::clear();
+  LCD::print("Accel search...");
+  LinearMotor::StallLimit accel = motor.findAccelLimit(ACCEL_LO, ACCEL_HI, CRUISE_RPS, ACCEL_RES);  // lo, hi, cruiseRPS, resolution
+
+  LCD::clear();
+  LCD::print("Speed search...");
+  LinearMotor::StallLimit speed = motor.findSpeedLimit(SPEED_LO, SPEED_HI, SPEED_ACCEL, SPEED_RES); // lo, hi, accel, resolution
 
+  motor.saveCalibration(CALIB_ADDR);       // eepromAddr — keeps the measured limits
   Serial.println("=== STALL TEST COMPLETE ===");
   LCD::clear();
-  LCD::print("Done!");
+  showLimit("A", accel, 0);
   LCD::setCursor(0, 1);  // col, row
-  LCD::print("Press to repeat");
+  showLimit("V", speed, 2);
 }
@@ -0,0 +1,79 @@
+// step_timer.h
+// Hardware step clock: one 16-bit timer per motor axis in CTC mode, prescaler 8 (0.5 µs ticks).
+// The compare-match ISR calls MotorBase::onStepTimer(), which emits the pulse and loads the
+// next period, so moves run in the background instead of busy-waiting in delayMicroseconds().
+// ATmega2560 provides Timer1/3/4/5 (up to 4 axes); Timer0 (millis) and Timer2 (tone/PWM 9-10)
+// are left alone. Timer1 conflicts with the Servo library.
+//
+// Hardware pulse mode (attachPulse): when the STEP pin is one of the timer's output-compare
+// pins, the timer sets it on the compare match itself, so interrupts (millis, Serial TX,
+// limit ISRs) no longer move the step edge. The ISR only clears the pin again and arms the
+// next match. Output-compare pins on the Mega:
+//   Timer1 OC1A/B/C = D11/D12/D13    Timer3 OC3A/B/C = D5/D2/D3
+//   Timer4 OC4A/B/C = D6/D7/D8       Timer5 OC5A/B/C = D46/D45/D44
+// Off-target builds get a discrete-event simulation of the same slots: service() waits
+// (delayMicroseconds) until the earliest pending compare match and fires it, so the ISR path
+// can be exercised against the virtual clock of the host HAL (host/hal).
+
+#pragma once
+
+#include <Arduino.h>
+
+class MotorBase;
+
+namespace StepTimer {
+
+  // Timer ticks per microsecond at F_CPU = 16 MHz with prescaler 8.
+  static const uint8_t TICKS_PER_US = 2;
+
+  // Shortest compare interval ever loaded, in ticks. Keeps OCR ahead of TCNT after ISR latency.
+  static const uint16_t MIN_TICKS = 32;
+
+  // STEP high time in hardware pulse mode, in ticks: the Applied Motion minimum of 5 µs.
+  static const uint8_t PULSE_TICKS = 10;
+
+  // Claim a free timer for motor. Returns the slot index, or -1 when every slot is taken.
+  // Off-target builds get 4 simulated slots, driven by service() (the host simulator).
+  int8_t attach(MotorBase* motor);
+
+  // Claim the timer whose output-compare pin is stepPin, in hardware pulse mode. Returns the
+  // slot, or -1 when stepPin is no timer output or its timer is taken (attach pulse axes
+  // before plain ones). Off-target any pin is accepted and the edges are simulated.
+  int8_t attachPulse(MotorBase* motor, uint8_t stepPin);
+
+  // Stop the timer and release the slot.
+  void detach(int8_t slot);
+
+  // Keep slot's timer away from attach() / attachPulse() while it serves something else
+  // (input capture, see tach_capture.h). Returns false when a motor already has it.
+  bool reserve(int8_t slot);
+  void release(int8_t slot);
+
+  // Start counting; the first compare match fires after MIN_TICKS.
+  // In hardware pulse mode that first match is armed to raise the step pin.
+  void start(int8_t slot);
+
+  // Stop counting and mask the compare interrupt.
+  void stop(int8_t slot);
+
+  // Load the compare register for the next interval of up to 65536 ticks.
+  // Longer waits are split; returns the ticks still owed after this interval.
+  // Must be called from the ISR or with interrupts disabled.
+  unsigned long load(int8_t slot, unsigned long ticks);
+
+  // Hardware pulse mode, from the ISR: whether the next compare match raises the step pin.
+  // If that match has already passed, a step edge is forced at once (late, as in software).
+  void armPulse(int8_t slot, bool step);
+
+  // Hardware pulse mode, from the ISR of a step match: clear the step pin once it has been
+  // high PULSE_TICKS, then armPulse(slot, nextStep).
+  void endPulse(int8_t slot, bool nextStep);
+
+  // Called from busy-wait loops while a timed move is running.
+  // No-op on hardware; off-target it fires the next simulated compare match.
+  void service();
+
+  // Off-target only: time of the last simulated compare match, in ticks of the micros() clock.
+  unsigned long simTicks();
+
+} // namespace StepTimer
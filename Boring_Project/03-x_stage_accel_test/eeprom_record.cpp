@@ -0,0 +1,69 @@
+// eeprom_record.cpp
+// EepromRecord: versioned, CRC-checked EEPROM blocks.
+
+#include <EEPROM.h>
+#include "lib/util/eeprom_record.h"
+
+namespace {
+  static const uint8_t MAGIC[2] = {'M', 'B'};
+}
+
+namespace EepromRecord {
+
+uint16_t crc16(uint16_t crc, uint8_t byte) {
+  crc ^= (uint16_t)byte << 8;
+  for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  return crc;
+}
+
+bool write(int addr, uint8_t version, const void* data, uint8_t size) {
+  if (addr < 0 || addr + span(size) > (int)EEPROM.length()) {
+    Serial.println("EepromRecord::write: record does not fit in the EEPROM.");
+    return false;
+  }
+  const uint8_t header[4] = {MAGIC[0], MAGIC[1], version, size};
+  const uint8_t* bytes    = (const uint8_t*)data;
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < 4; i++)    { EEPROM.update(addr++, header[i]); crc = crc16(crc, header[i]); }
+  for (uint8_t i = 0; i < size; i++) { EEPROM.update(addr++, bytes[i]);  crc = crc16(crc, bytes[i]);  }
+  EEPROM.update(addr++, crc & 0xFF);
+  EEPROM.update(addr,   crc >> 8);
+  return true;
+}
+
+// Checked in place before anything is copied, so a bad record leaves data as it was.
+bool read(int addr, uint8_t version, void* data, uint8_t size) {
+  if (addr < 0 || addr + span(size) > (int)EEPROM.length()) {
+    Serial.println("EepromRecord::read: record does not fit in the EEPROM.");
+    return false;
+  }
+  if (EEPROM.read(addr) != MAGIC[0] || EEPROM.read(addr + 1) != MAGIC[1]) {
+    Serial.print("EepromRecord::read: no record at "); Serial.print(addr); Serial.println(".");
+    return false;
+  }
+  if (EEPROM.read(addr + 2) != version || EEPROM.read(addr + 3) != size) {
+    Serial.print("EepromRecord::read: record at "); Serial.print(addr);
+    Serial.print(" is version "); Serial.print(EEPROM.read(addr + 2));
+    Serial.print(" ("); Serial.print(EEPROM.read(addr + 3)); Serial.print(" bytes), expected ");
+    Serial.print(version); Serial.print(" ("); Serial.print(size); Serial.println(" bytes).");
+    return false;
+  }
+  uint16_t crc = 0xFFFF;
+  for (int i = 0; i < 4 + size; i++) crc = crc16(crc, EEPROM.read(addr + i));
+  uint16_t stored = EEPROM.read(addr + 4 + size) | ((uint16_t)EEPROM.read(addr + 5 + size) << 8);
+  if (crc != stored) {
+    Serial.print("EepromRecord::read: CRC mismatch at "); Serial.print(addr); Serial.println(".");
+    return false;
+  }
+  uint8_t* bytes = (uint8_t*)data;
+  for (uint8_t i = 0; i < size; i++) bytes[i] = EEPROM.read(addr + 4 + i);
+  return true;
+}
+
+void erase(int addr) {
+  if (addr < 0 || addr + 1 >= (int)EEPROM.length()) return;
+  EEPROM.update(addr,     0xFF);
+  EEPROM.update(addr + 1, 0xFF);
+}
+
+} // namespace EepromRecord
@@ -0,0 +1,50 @@
+// motion_group.h
+// Coordinated straight-line moves across several MotorBase axes on one step clock.
+// The axis with the most steps is the master: it runs an ordinary trapezoid through its own
+// generator (step timer ISR or blocking loop). On every master step each other axis takes a
+// Bresenham/DDA decision, so all axes start and finish together on a straight line.
+//
+// Usage:
+//   MotorBase* const XZ_AXES[] = {&xMotor, &zMotor};
+//   MotionGroup xz;
+//   xz.init(XZ_AXES, 2);
+//   const float XZ_MOVE[] = {10, 14};     // revolutions per axis, in init() order
+//   xz.moveLinear(XZ_MOVE, 5, 20);        // feed rev/s, accel rev/s²
+//
+// A limit hit on any axis stops the whole group along the same line. In the blocking loop
+// each follower pulse adds its pulse width to the master period; attach a step timer to the
+// master axis for exact timing.
+
+#pragma once
+
+#include <Arduino.h>
+#include "motor_base.h"
+
+class MotionGroup {
+public:
+  static const uint8_t MAX_AXES = 4;
+
+  // Register the axes in the order moveLinear() takes their distances. Each axis must be
+  // init()ed first; extra axes beyond MAX_AXES are ignored.
+  void init(MotorBase* const* axes, uint8_t count);
+
+  // Relative straight-line move of revs[i] on axis i. feedRPS (rev/s) and accel (rev/s²)
+  // apply to the axis travelling the most revolutions; the others are scaled down so every
+  // axis arrives at the same time. Falls back to a triangle profile when the distance
+  // cannot reach feedRPS. Blocking: a move or jog still running on any axis finishes first.
+  void moveLinear(const float* revs, float feedRPS, float accel);
+
+  // Called by the master axis after each of its pulses (possibly from the step timer ISR).
+  void onMasterStep();
+
+  // True when a follower is moving into a triggered limit switch.
+  bool limitTriggered();
+
+private:
+  MotorBase* _axes[MAX_AXES];
+  uint8_t    _count;
+  uint8_t    _master;             // index of the axis clocked by the profile
+  long       _masterSteps;        // Bresenham denominator: planned master steps
+  long       _delta[MAX_AXES];    // planned steps per axis
+  long       _err[MAX_AXES];      // Bresenham accumulators
+};
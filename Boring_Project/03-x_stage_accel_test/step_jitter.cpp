@@ -0,0 +1,115 @@
+// step_jitter.cpp
+// StepJitter: per-phase step timing statistics and worst-step log.
+
+#include "lib/motor/step_jitter.h"
+
+static const char* const PHASE_NAMES[] = {"accel", "cruise", "decel", "limit"};
+
+void StepJitter::reset() {
+  for (uint8_t p = 0; p < PHASES; p++) {
+    PhaseStats& s = _stats[p];
+    s.count  = 0;
+    s.minErr = s.maxErr = s.sumErr = 0;
+    for (uint8_t b = 0; b < BINS; b++) s.bins[b] = 0;
+  }
+  _worstCount = 0;
+  beginMove();
+}
+
+void StepJitter::beginMove() {
+  _step      = 0;
+  _lastPhase = 0;
+}
+
+void StepJitter::record(uint8_t phase, unsigned long periodUs, unsigned long nowUs) {
+  if (_lastPhase >= 1 && _lastPhase <= PHASES) {
+    unsigned long actual = nowUs - _lastUs;
+    long          err    = (long)(actual - _lastPeriodUs);
+    unsigned long absErr = (err < 0) ? -err : err;
+
+    PhaseStats& s = _stats[_lastPhase - 1];
+    if (s.count == 0 || err < s.minErr) s.minErr = err;
+    if (s.count == 0 || err > s.maxErr) s.maxErr = err;
+    s.sumErr += err;
+    s.count++;
+    s.bins[binOf(absErr)]++;
+
+    if (absErr > 0) {
+      Offender o = {_step, _lastPeriodUs, actual, _lastPhase};
+      logWorst(o);
+    }
+  }
+  _step++;
+  _lastUs       = nowUs;
+  _lastPeriodUs = periodUs;
+  _lastPhase    = phase;
+}
+
+unsigned long StepJitter::steps(uint8_t phase) const {
+  return (phase >= 1 && phase <= PHASES) ? _stats[phase - 1].count : 0;
+}
+
+unsigned long StepJitter::maxErrorUs(uint8_t phase) const {
+  if (phase < 1 || phase > PHASES) return 0;
+  const PhaseStats& s = _stats[phase - 1];
+  return max(labs(s.minErr), labs(s.maxErr));
+}
+
+uint8_t StepJitter::binOf(unsigned long absErr) {
+  uint8_t b = 0;
+  while (absErr > 0 && b < BINS - 1) { absErr >>= 1; b++; }
+  return b;
+}
+
+unsigned long StepJitter::percentile(const PhaseStats& s, uint8_t pct) {
+  unsigned long need = (s.count * pct + 99) / 100;
+  unsigned long seen = 0;
+  for (uint8_t b = 0; b < BINS; b++) {
+    seen += s.bins[b];
+    if (seen >= need) return (1UL << b) - 1;
+  }
+  return (1UL << BINS) - 1;
+}
+
+void StepJitter::logWorst(const Offender& o) {
+  long    absErr = labs(o.errUs());
+  uint8_t i      = _worstCount;
+  if (i == WORST_LOG) {
+    if (absErr <= labs(_worst[WORST_LOG - 1].errUs())) return;
+    i--;
+  } else {
+    _worstCount++;
+  }
+  // Insertion into the sorted log: shift smaller entries down.
+  while (i > 0 && absErr > labs(_worst[i - 1].errUs())) {
+    _worst[i] = _worst[i - 1];
+    i--;
+  }
+  _worst[i] = o;
+}
+
+void StepJitter::report() const {
+  Serial.println("--- Step Jitter (actual - commanded period, us) ---");
+  for (uint8_t p = 0; p < PHASES; p++) {
+    const PhaseStats& s = _stats[p];
+    if (s.count == 0) continue;
+    Serial.print(PHASE_NAMES[p]); Serial.print(": steps="); Serial.print(s.count);
+    Serial.print(", min="); Serial.print(s.minErr);
+    Serial.print(", mean="); Serial.print((float)s.sumErr / s.count, 2);
+    Serial.print(", max="); Serial.print(s.maxErr);
+    Serial.print(", |err| p50<="); Serial.print(percentile(s, 50));
+    Serial.print(" p90<="); Serial.print(percentile(s, 90));
+    Serial.print(" p99<="); Serial.println(percentile(s, 99));
+  }
+  if (_worstCount == 0) return;
+  Serial.println("Worst steps:");
+  for (uint8_t i = 0; i < _worstCount; i++) {
+    const Offender& o = _worst[i];
+    Serial.print("  step "); Serial.print(o.step);
+    Serial.print(" ("); Serial.print(PHASE_NAMES[o.phase - 1]);
+    Serial.print("): commanded "); Serial.print(o.commandedUs);
+    Serial.print(", actual "); Serial.print(o.actualUs);
+    Serial.print(" ("); if (o.errUs() > 0) Serial.print("+");
+    Serial.print(o.errUs()); Serial.println(")");
+  }
+}
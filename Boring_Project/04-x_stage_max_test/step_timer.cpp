@@ -0,0 +1,239 @@
+// step_timer.cpp
+// StepTimer: 16-bit timer slot table and compare-match ISR stubs.
+
+#include "lib/driver/timer/step_timer.h"
+#include "lib/motor/motor_base.h"
+
+// ── Slot table ────────────────────────────────────────────────────────────────
+// Each slot owns one hardware timer and one COMPA ISR stub.
+// Stubs call the public onStepTimer() hook on MotorBase.
+
+namespace {
+
+#if defined(__AVR__)
+
+  struct TimerRegs {
+    volatile uint8_t*  tccrA;
+    volatile uint8_t*  tccrB;
+    volatile uint8_t*  tccrC;
+    volatile uint16_t* tcnt;
+    volatile uint16_t* ocrA;
+    volatile uint16_t* ocrB;
+    volatile uint16_t* ocrC;
+    volatile uint8_t*  timsk;
+    volatile uint8_t*  tifr;
+    uint8_t            ocPins[3];   // OCnA/B/C digital pins; 0xFF = none
+  };
+
+  // WGMn2, CSn1, OCIEnA, OCFnA, the COMnx pairs and FOCnx sit at the same bit positions on
+  // every 16-bit timer.
+  static const TimerRegs TIMERS[] = {
+#if defined(TCCR3A)
+    {&TCCR1A, &TCCR1B, &TCCR1C, &TCNT1, &OCR1A, &OCR1B, &OCR1C, &TIMSK1, &TIFR1, {11, 12, 13}},
+    {&TCCR3A, &TCCR3B, &TCCR3C, &TCNT3, &OCR3A, &OCR3B, &OCR3C, &TIMSK3, &TIFR3, { 5,  2,  3}},
+    {&TCCR4A, &TCCR4B, &TCCR4C, &TCNT4, &OCR4A, &OCR4B, &OCR4C, &TIMSK4, &TIFR4, { 6,  7,  8}},
+    {&TCCR5A, &TCCR5B, &TCCR5C, &TCNT5, &OCR5A, &OCR5B, &OCR5C, &TIMSK5, &TIFR5, {46, 45, 44}},
+#else
+    {&TCCR1A, &TCCR1B, &TCCR1C, &TCNT1, &OCR1A, &OCR1B, nullptr, &TIMSK1, &TIFR1, { 9, 10, 0xFF}},
+#endif
+  };
+
+  // COMnx bits for channel ch (0..2 = A/B/C) in TCCRnA: 10 = clear on match, 11 = set.
+  inline uint8_t comMask(int8_t ch)  { return 3 << (6 - 2 * ch); }
+  inline uint8_t comClear(int8_t ch) { return 2 << (6 - 2 * ch); }
+
+  static const int MAX_SLOTS = sizeof(TIMERS) / sizeof(TIMERS[0]);
+
+#else
+
+  // Simulated timers: absolute deadline per running slot, in ticks of the micros() clock.
+  // _simNow is the time of the compare match being served, which the next deadline counts
+  // from (CTC), even when the ISR body has run the clock past it.
+  static const int MAX_SLOTS = 4;
+  static unsigned long _simNow = 0;
+  static unsigned long _deadline[MAX_SLOTS];
+  static bool          _running[MAX_SLOTS];
+  static bool          _armed[MAX_SLOTS];
+  static uint8_t       _simPin[MAX_SLOTS];
+
+#endif
+
+  static MotorBase* _motors[4]  = {nullptr, nullptr, nullptr, nullptr};
+  static int8_t     _channel[4] = {-1, -1, -1, -1};   // hardware pulse channel; -1 = ISR pulses
+  static bool       _reserved[4] = {false, false, false, false};
+
+} // anonymous namespace
+
+#if defined(__AVR__)
+ISR(TIMER1_COMPA_vect) { if (_motors[0]) _motors[0]->onStepTimer(); }
+#if defined(TCCR3A)
+ISR(TIMER3_COMPA_vect) { if (_motors[1]) _motors[1]->onStepTimer(); }
+ISR(TIMER4_COMPA_vect) { if (_motors[2]) _motors[2]->onStepTimer(); }
+ISR(TIMER5_COMPA_vect) { if (_motors[3]) _motors[3]->onStepTimer(); }
+#endif
+#endif
+
+namespace StepTimer {
+
+int8_t attach(MotorBase* motor) {
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    if (_motors[i] == nullptr && !_reserved[i]) {
+      _motors[i] = motor;
+      stop(i);
+      return i;
+    }
+  }
+  return -1;
+}
+
+int8_t attachPulse(MotorBase* motor, uint8_t stepPin) {
+#if defined(__AVR__)
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    for (int8_t c = 0; c < 3; c++) {
+      if (TIMERS[i].ocPins[c] != stepPin) continue;
+      if (_motors[i] != nullptr || _reserved[i]) return -1;
+      _motors[i]  = motor;
+      _channel[i] = c;
+      stop(i);
+      return i;
+    }
+  }
+  return -1;
+#else
+  int8_t slot = attach(motor);
+  if (slot >= 0) {
+    _channel[slot] = 0;
+    _simPin[slot]  = stepPin;
+  }
+  return slot;
+#endif
+}
+
+void detach(int8_t slot) {
+  if (slot < 0 || slot >= MAX_SLOTS) return;
+  stop(slot);
+  _motors[slot]  = nullptr;
+  _channel[slot] = -1;
+}
+
+bool reserve(int8_t slot) {
+  if (slot < 0 || slot >= MAX_SLOTS || _motors[slot] != nullptr) return false;
+  _reserved[slot] = true;
+  return true;
+}
+
+void release(int8_t slot) {
+  if (slot >= 0 && slot < MAX_SLOTS) _reserved[slot] = false;
+}
+
+void start(int8_t slot) {
+#if defined(__AVR__)
+  const TimerRegs& t = TIMERS[slot];
+  uint8_t sreg = SREG;
+  cli();
+  *t.tccrA  = 0;
+  *t.tccrB  = 0;
+  *t.tcnt   = 0;
+  *t.ocrA   = MIN_TICKS - 1;
+  int8_t ch = _channel[slot];
+  if (ch >= 0) {
+    if (ch == 1) *t.ocrB = 0;             // B/C match at BOTTOM, one tick after the A match
+    if (ch == 2) *t.ocrC = 0;
+    *t.tccrA = comClear(ch);
+    *t.tccrC = _BV(FOC1A - ch);           // step pin low before the timer takes it over
+    *t.tccrA = comMask(ch);               // first match raises it
+  }
+  *t.tifr   = _BV(OCF1A);                 // drop any stale match
+  *t.timsk |= _BV(OCIE1A);
+  *t.tccrB  = _BV(WGM12) | _BV(CS11);     // CTC on OCRnA, clk/8
+  SREG = sreg;
+#else
+  _running[slot]  = true;
+  _armed[slot]    = true;
+  _deadline[slot] = micros() * TICKS_PER_US + MIN_TICKS;
+#endif
+}
+
+void stop(int8_t slot) {
+#if defined(__AVR__)
+  const TimerRegs& t = TIMERS[slot];
+  uint8_t sreg = SREG;
+  cli();
+  *t.tccrB  = 0;
+  *t.tccrA  = 0;                          // step pin back to its PORT bit
+  *t.timsk &= ~_BV(OCIE1A);
+  SREG = sreg;
+#else
+  _running[slot] = false;
+#endif
+}
+
+unsigned long load(int8_t slot, unsigned long ticks) {
+  // Split long waits so the final interval is never shorter than half the counter range.
+  unsigned long chunk = ticks;
+  if (chunk > 65536UL) chunk = min(65536UL, ticks - 32768UL);
+  if (chunk < MIN_TICKS) chunk = MIN_TICKS;
+#if defined(__AVR__)
+  *TIMERS[slot].ocrA = (uint16_t)(chunk - 1);
+#else
+  _deadline[slot] = _simNow + chunk;
+#endif
+  return (ticks > chunk) ? ticks - chunk : 0;
+}
+
+void armPulse(int8_t slot, bool step) {
+  int8_t ch = _channel[slot];
+#if defined(__AVR__)
+  const TimerRegs& t = TIMERS[slot];
+  if (!step) {
+    *t.tccrA = (*t.tccrA & ~comMask(ch)) | comClear(ch);
+    return;
+  }
+  *t.tccrA |= comMask(ch);
+  if (*t.tifr & _BV(OCF1A)) *t.tccrC = _BV(FOC1A - ch);   // the ISR overran the match
+#else
+  (void)ch;
+  _armed[slot] = step;
+#endif
+}
+
+void endPulse(int8_t slot, bool nextStep) {
+  int8_t ch = _channel[slot];
+#if defined(__AVR__)
+  const TimerRegs& t = TIMERS[slot];
+  while (*t.tcnt < PULSE_TICKS && !(*t.tifr & _BV(OCF1A))) {}
+  *t.tccrA = (*t.tccrA & ~comMask(ch)) | comClear(ch);
+  *t.tccrC = _BV(FOC1A - ch);
+#else
+  (void)ch;
+  digitalWrite(_simPin[slot], LOW);
+#endif
+  armPulse(slot, nextStep);
+}
+
+void service() {
+#if !defined(__AVR__)
+  int next = -1;
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    if (!_running[i]) continue;
+    if (next < 0 || (long)(_deadline[i] - _deadline[next]) < 0) next = i;
+  }
+  if (next < 0) return;
+  // Wait out the time to the match, so a virtual-clock host HAL sees it happen on time.
+  long ahead = (long)(_deadline[next] - micros() * TICKS_PER_US);
+  if (ahead > 0) delayMicroseconds((ahead + TICKS_PER_US - 1) / TICKS_PER_US);
+  _simNow = _deadline[next];
+  if (_channel[next] >= 0 && _armed[next]) digitalWrite(_simPin[next], HIGH);
+  if (_motors[next]) _motors[next]->onStepTimer();
+#endif
+}
+
+unsigned long simTicks() {
+#if !defined(__AVR__)
+  return _simNow;
+#else
+  return 0;
+#endif
+}
+
+} // namespace StepTimer
@@ -0,0 +1,80 @@
+// ramp_table.h
+// Compile-time ramp tables for fixed, repeated moves.
+// RampTable<N, V> is a constant-acceleration ramp from standstill to V steps/s in N steps
+// (a = V² / (2N)). Every step period is evaluated by the compiler and stored in flash, so
+// MotorBase::tableTrapMove() replays it with one pgm_read_word() per step and no math —
+// the same move produces the same pulse train on every run.
+//
+// Usage:
+//   typedef RampTable<1000, 2000> X_RAMP;           // 1000 steps up to 2000 steps/s
+//   xMotor.tableTrapMove(X_RAMP::profile(), 10);    // accel, cruise, decel down the same table
+//
+// Flash cost is 2 bytes per ramp step. The first period must fit in 16 bits:
+// 1e6 / sqrt(2a) <= 65535 µs, i.e. a >= 117 steps/s².
+
+#pragma once
+
+#include <Arduino.h>
+
+// Flash-resident ramp descriptor consumed by MotorBase::tableTrapMove().
+struct RampProfile {
+  const uint16_t* periods;   // PROGMEM; periods[n - 1] = period (µs) of ramp index n
+  unsigned int    steps;     // ramp length N
+  unsigned long   speed;     // top speed V (steps/s)
+  uint16_t        cruiseUs;  // period at V
+};
+
+namespace ramp_table_detail {
+
+  // ── Index sequence (C++11, logarithmic instantiation depth) ────────────────
+  template <unsigned int... I> struct Seq { typedef Seq type; };
+
+  template <class A, class B> struct Concat;
+  template <unsigned int... A, unsigned int... B>
+  struct Concat<Seq<A...>, Seq<B...> > : Seq<A..., (sizeof...(A) + B)...> {};
+
+  template <unsigned int N>
+  struct MakeSeq : Concat<typename MakeSeq<N / 2>::type, typename MakeSeq<N - N / 2>::type> {};
+  template <> struct MakeSeq<0> : Seq<> {};
+  template <> struct MakeSeq<1> : Seq<0> {};
+
+  // ── constexpr math ─────────────────────────────────────────────────────────
+  // Newton iteration from g = x; 24 rounds covers x up to 65535 (N/n ratio) to float precision.
+  constexpr float sqrtIter(float x, float g, int rounds) {
+    return rounds == 0 ? g : sqrtIter(x, 0.5f * (g + x / g), rounds - 1);
+  }
+  constexpr float csqrt(float x) {
+    return x <= 0.0f ? 0.0f : sqrtIter(x, x > 1.0f ? x : 1.0f, 24);
+  }
+
+  // T_n = 1e6 / sqrt(2·a·n) with a = V² / (2N)  →  T_n = (1e6 / V) · sqrt(N / n), rounded.
+  constexpr float periodUs(unsigned int n, unsigned int N, unsigned long V) {
+    return (1000000.0f / V) * csqrt((float)N / n);
+  }
+  constexpr uint16_t periodWord(unsigned int n, unsigned int N, unsigned long V) {
+    return (uint16_t)(periodUs(n, N, V) + 0.5f);
+  }
+
+} // namespace ramp_table_detail
+
+template <unsigned int N, unsigned long V,
+          class Seq = typename ramp_table_detail::MakeSeq<N>::type>
+struct RampTable;
+
+template <unsigned int N, unsigned long V, unsigned int... I>
+struct RampTable<N, V, ramp_table_detail::Seq<I...> > {
+  static_assert(N > 0 && V > 0, "RampTable needs at least one step and a non-zero speed");
+  static_assert(ramp_table_detail::periodUs(1, N, V) <= 65535.0f,
+                "RampTable: first period exceeds 65535 us — ramp too gentle for a 16-bit table");
+
+  static const uint16_t periods[N] PROGMEM;
+
+  static constexpr RampProfile profile() {
+    return RampProfile{periods, N, V, ramp_table_detail::periodWord(N, N, V)};
+  }
+};
+
+template <unsigned int N, unsigned long V, unsigned int... I>
+const uint16_t RampTable<N, V, ramp_table_detail::Seq<I...> >::periods[N] PROGMEM = {
+  ramp_table_detail::periodWord(I + 1, N, V)...
+};
@@ -31,6 +31,7 @@ StepHBridgeDriver::StepHBridgeDriver(int in1Pin, int in2Pin, int in3Pin, int in4
                                      int enaPin, int enbPin,
                                      int stepsPerRev, uint8_t dutyCycle, bool halfStep)
   : _in1(in1Pin), _in2(in2Pin), _in3(in3Pin), _in4(in4Pin),
+    _in1Out(in1Pin), _in2Out(in2Pin), _in3Out(in3Pin), _in4Out(in4Pin),
     _enaPin(enaPin), _enbPin(enbPin),
     _spr(stepsPerRev), _dutyCycle(dutyCycle),
     _halfStep(halfStep), _forward(true), _phase(0) {}
@@ -60,11 +61,7 @@ void StepHBridgeDriver::enable() {
   // Energize coils to phase 0 so the rotor aligns to a known position.
   // Without this, all IN pins remain LOW (L298N brake mode) and the rotor
   // is unaligned when stepping begins, causing buzz instead of rotation.
-  const uint8_t* row = _halfStep ? HALF_STEPS[_phase] : FULL_STEPS[_phase];
-  digitalWrite(_in1, row[0]);
-  digitalWrite(_in2, row[1]);
-  digitalWrite(_in3, row[2]);
-  digitalWrite(_in4, row[3]);
+  writePhase();
 }
 
 void StepHBridgeDriver::disable() {
@@ -79,14 +76,25 @@ void StepHBridgeDriver::advance() {
   } else {
     _phase = (_phase == 0) ? (tableSize - 1) : (_phase - 1);
   }
+  writePhase();
+}
+
+void StepHBridgeDriver::writePhase() {
   const uint8_t* row = _halfStep ? HALF_STEPS[_phase] : FULL_STEPS[_phase];
-  digitalWrite(_in1, row[0]);
-  digitalWrite(_in2, row[1]);
-  digitalWrite(_in3, row[2]);
-  digitalWrite(_in4, row[3]);
+  _in1Out.write(row[0]);
+  _in2Out.write(row[1]);
+  _in3Out.write(row[2]);
+  _in4Out.write(row[3]);
 }
 
 void StepHBridgeDriver::step(unsigned long stepPeriodUs) {
   advance();
   delayMicroseconds(stepPeriodUs);
 }
+
+void StepHBridgeDriver::stepBurst(const unsigned long* periods, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    advance();
+    delayMicroseconds(periods[i]);
+  }
+}
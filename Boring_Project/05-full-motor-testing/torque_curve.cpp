@@ -0,0 +1,34 @@
+// torque_curve.cpp
+// TorqueCurve: speed → acceleration table for MotorBase::curveMove().
+
+#include "lib/motor/torque_curve.h"
+
+bool TorqueCurve::init(const Point* points, uint8_t count) {
+  if (count == 0 || count > MAX_POINTS) {
+    Serial.println("TorqueCurve::init: 1 to MAX_POINTS points.");
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (points[i].accel <= 0.0f || points[i].rps < 0.0f ||
+        (i > 0 && points[i].rps <= points[i - 1].rps)) {
+      Serial.println("TorqueCurve::init: rps must rise from 0 up, every accel above 0.");
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < count; i++) _points[i] = points[i];
+  _pointCount = count;
+  _zoneCount  = 0;                  // rebuilt by MotorBase::setTorqueCurve()
+  return true;
+}
+
+float TorqueCurve::accelAt(float rps) const {
+  if (_pointCount == 0) return 0.0f;
+  rps = fabs(rps);
+  if (rps <= _points[0].rps) return _points[0].accel;
+  for (uint8_t i = 1; i < _pointCount; i++) {
+    const Point& lo = _points[i - 1];
+    const Point& hi = _points[i];
+    if (rps <= hi.rps) return lo.accel + (hi.accel - lo.accel) * (rps - lo.rps) / (hi.rps - lo.rps);
+  }
+  return _points[_pointCount - 1].accel;
+}
@@ -0,0 +1,87 @@
+// FastPin Microbenchmark — digitalWrite() vs direct port writes, per pin write and per step
+// Step/dir driver (STR3): Dir=D30, Step=D31 | H-bridge (L298N): IN1–IN4=D32–D35, ENA/ENB unused
+// Use free pins (or disconnect the drivers): every test below toggles its pins.
+// Results go to Serial at 115200; each line is the cost of one operation in µs.
+
+#include "lib/driver/stepper/str3.h"
+#include "lib/driver/stepper/l298n.h"
+#include "lib/driver/gpio/fast_pin.h"
+
+// ── CONFIGURATION ──────────────────────────────────────────────────────────────
+const int      DIR_PIN    = 30;
+const int      STEP_PIN   = 31;
+const int      IN_PINS[4] = {32, 33, 34, 35};
+const uint16_t ITERATIONS = 10000;
+// ──────────────────────────────────────────────────────────────────────────────
+
+STR3    stepDriver(DIR_PIN, STEP_PIN, 200);                              // dirPin, stepPin, stepsPerRev
+L298N   bridgeDriver(IN_PINS[0], IN_PINS[1], IN_PINS[2], IN_PINS[3],
+                     -1, -1, 200);                                       // in1–in4, ena, enb, stepsPerRev
+FastPin stepPin(STEP_PIN);
+
+float loopUs = 0.0f;   // empty-loop overhead per iteration, subtracted from every result
+
+// Time ITERATIONS calls of op and return µs per call, less the loop overhead.
+// Interrupts stay on (micros() needs the Timer0 overflow); its tick costs every test alike.
+template <typename Op>
+float timeOp(Op op) {
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < ITERATIONS; i++) op();
+  unsigned long elapsed = micros() - start;
+  return (float)elapsed / ITERATIONS - loopUs;
+}
+
+void report(const char* label, float us) {
+  Serial.print(label); Serial.print(us, 3); Serial.println(" us");
+}
+
+// ── Reference implementations: the drivers as they were before FastPin ────────
+
+void digitalWritePulse() {
+  digitalWrite(STEP_PIN, HIGH);
+  delayMicroseconds(StepMotorDriver::PULSE_US);
+  digitalWrite(STEP_PIN, LOW);
+}
+
+void digitalWritePhase() {
+  static uint8_t phase = 0;
+  static const uint8_t ROWS[4][4] = {
+    {HIGH, LOW, HIGH, LOW}, {LOW, HIGH, HIGH, LOW}, {LOW, HIGH, LOW, HIGH}, {HIGH, LOW, LOW, HIGH},
+  };
+  phase = (phase + 1) % 4;
+  for (uint8_t p = 0; p < 4; p++) digitalWrite(IN_PINS[p], ROWS[phase][p]);
+}
+
+void setup() {
+  Serial.begin(115200);
+  stepDriver.init();
+  bridgeDriver.init();
+  FastPinT<STEP_PIN>::output();
+
+  Serial.println("=== FASTPIN MICROBENCHMARK ===");
+  Serial.print("Iterations per test: "); Serial.println(ITERATIONS);
+
+  loopUs = timeOp([] { __asm__ __volatile__("nop"); });
+  Serial.print("Loop overhead: "); Serial.print(loopUs, 3); Serial.println(" us");
+
+  Serial.println("--- One HIGH + LOW pair ---");
+  report("digitalWrite:      ", timeOp([] { digitalWrite(STEP_PIN, HIGH); digitalWrite(STEP_PIN, LOW); }));
+  report("FastPin:           ", timeOp([] { stepPin.high(); stepPin.low(); }));
+  report("FastPinT<STEP_PIN>:", timeOp([] { FastPinT<STEP_PIN>::high(); FastPinT<STEP_PIN>::low(); }));
+
+  Serial.println("--- Step/dir driver pulse (includes the PULSE_US high time) ---");
+  float before = timeOp(digitalWritePulse);
+  float after  = timeOp([] { stepDriver.pulse(); });
+  report("digitalWrite pulse: ", before);
+  report("STR3::pulse():      ", after);
+  report("Saved per step:     ", before - after);
+
+  Serial.println("--- H-bridge phase advance (4 phase pins) ---");
+  before = timeOp(digitalWritePhase);
+  after  = timeOp([] { bridgeDriver.advance(); });
+  report("digitalWrite phase: ", before);
+  report("L298N::advance():   ", after);
+  report("Saved per step:     ", before - after);
+}
+
+void loop() {}
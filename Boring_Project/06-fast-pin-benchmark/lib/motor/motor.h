@@ -0,0 +1,39 @@
+// motor.h
+// Axis bound to a concrete driver type at compile time.
+// Motor<Driver, Axis> owns its driver and installs a blocking step loop instantiated for
+// Driver, so with a final driver (StaticStepDriver) the per-step driver call is resolved and
+// inlined by the compiler instead of going through the StepperDriver vtable. Everything
+// else — planning, limits, MotionGroup, MoveQueue, LCD — sees an ordinary Axis.
+// The step timer ISR and poll() still emit through the virtual pulse(); their cost is set
+// by the timer, not the call.
+//
+// Usage:
+//   Motor<StaticSTR3<24, 25, 3200> > zMotor;                // RotationalMotor axis
+//   Motor<StaticSTR3<51, 53, 200>, LinearMotor> xMotor;     // LinearMotor axis
+//   zMotor.init(2);                                         // id
+//   xMotor.init(1, 2, 3, 6.0f, 15.0f);                      // id, then Axis::init args after driver
+
+#pragma once
+
+#include "rotational_motor.h"
+
+template <class Driver, class Axis = RotationalMotor>
+class Motor : public Axis {
+public:
+  // Same as Axis::init(id, driver, args...), with the owned driver.
+  template <class... Args>
+  void init(uint8_t id, Args... args) {
+    Axis::init(id, &_drv, args...);
+    this->setStepLoop(&Motor::stepLoop);
+  }
+
+  Driver& driver() { return _drv; }
+
+private:
+  Driver _drv;
+
+  static void stepLoop(MotorBase& motor) {
+    Motor& self = static_cast<Motor&>(motor);
+    self.runStepLoop(self._drv);
+  }
+};
@@ -0,0 +1,60 @@
+// Static Driver Benchmark — virtual StepperDriver* vs compile-time bound Motor<Driver>
+// Step/dir driver (STR3): Dir=D30, Step=D31. Both axes drive the same pins, one after the other.
+// Use free pins (or disconnect the driver): every test below pulses the step pin.
+// Each speed runs a constant-speed spinRevs() on both axes. A step loop with zero overhead
+// would take exactly steps × period; the excess, divided by steps, is the per-step cost of
+// the loop (generator, bookkeeping, driver call). Results go to Serial at 115200.
+
+#include "lib/driver/stepper/str3.h"
+#include "lib/driver/stepper/static_step_driver.h"
+#include "lib/motor/rotational_motor.h"
+#include "lib/motor/motor.h"
+
+// ── CONFIGURATION ──────────────────────────────────────────────────────────────
+const uint8_t DIR_PIN       = 30;
+const uint8_t STEP_PIN      = 31;
+const int     STEPS_PER_REV = 200;
+const float   REVOLUTIONS   = 10;
+const float   SPEEDS_RPS[]  = {1, 5, 10, 20, 40};
+const int     NUM_SPEEDS    = sizeof(SPEEDS_RPS) / sizeof(SPEEDS_RPS[0]);
+// ──────────────────────────────────────────────────────────────────────────────
+
+STR3            virtualDriver(DIR_PIN, STEP_PIN, STEPS_PER_REV);   // dirPin, stepPin, stepsPerRev
+RotationalMotor virtualMotor;                                      // steps through StepperDriver*
+Motor<StaticSTR3<DIR_PIN, STEP_PIN, STEPS_PER_REV> > staticMotor;  // steps through the concrete type
+
+// Run one spin and return the loop's overhead per step in µs.
+float overheadUs(MotorBase& motor, float rps) {
+  long  steps    = (long)(REVOLUTIONS * STEPS_PER_REV);
+  float periodUs = 1e6 / (rps * STEPS_PER_REV);
+  unsigned long start = micros();
+  motor.spinRevs(REVOLUTIONS, rps);
+  unsigned long elapsed = micros() - start;
+  return (elapsed - steps * periodUs) / steps;
+}
+
+void setup() {
+  Serial.begin(115200);
+  virtualMotor.init(1, &virtualDriver);   // id, driver
+  staticMotor.init(2);                    // id
+
+  Serial.println("=== STATIC DRIVER BENCHMARK ===");
+  Serial.print("Revolutions per test: "); Serial.print(REVOLUTIONS);
+  Serial.print(" @ "); Serial.print(STEPS_PER_REV); Serial.println(" spr");
+  Serial.println("RPS, Period (us), Virtual (us/step), Static (us/step), Saved (us/step)");
+
+  for (int i = 0; i < NUM_SPEEDS; i++) {
+    float rps       = SPEEDS_RPS[i];
+    float virtualUs = overheadUs(virtualMotor, rps);
+    float staticUs  = overheadUs(staticMotor, rps);
+    Serial.print(rps); Serial.print(", ");
+    Serial.print(1e6 / (rps * STEPS_PER_REV), 1); Serial.print(", ");
+    Serial.print(virtualUs, 2); Serial.print(", ");
+    Serial.print(staticUs, 2); Serial.print(", ");
+    Serial.println(virtualUs - staticUs, 2);
+    delay(250);
+  }
+  Serial.println("=== DONE ===");
+}
+
+void loop() {}
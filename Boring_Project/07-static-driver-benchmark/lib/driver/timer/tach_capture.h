@@ -0,0 +1,75 @@
+// tach_capture.h
+// Non-blocking tach velocity from the timer input-capture unit.
+// Each falling tach edge latches the running timer count in hardware (ICRn), so the edge is
+// timestamped to one 0.5 µs tick no matter what the CPU was doing; the capture ISR only
+// turns successive stamps into periods. Readings are computed on demand from the last
+// period, so rps() and filteredRPS() can be called any time — from the motion loop, a
+// poll() loop or the LCD — without waiting for pulses.
+//
+//   rps()          instantaneous: last edge-to-edge period
+//   filteredRPS()  exponential average over ~2^FILTER_SHIFT periods
+//   ripplePct()    peak-to-peak period spread / mean since resetRipple(), in % — at a steady
+//                  commanded speed this is the velocity ripple; a resonance shows as a jump
+//
+// When the edges stop, both readings fall as 1 / (time since the last edge), and read 0
+// after STOP_US. The tach has no direction; readings are unsigned.
+//
+// Input-capture pins on the Mega: D49 (ICP4, Timer4) and D48 (ICP5, Timer5); ICP1 and ICP3
+// are not broken out. The timer is taken from StepTimer (reserve()), so claim the tach
+// before attaching step timers. The same tach line can also feed MotorBase::attachTach()
+// on an interrupt pin. Off-target any interrupt pin works, stamped with micros().
+//
+// Usage:
+//   TachCapture tach;
+//   tach.begin(48, 100);                  // icpPin, pulsesPerRev
+//   ... tach.rps(), tach.filteredRPS(), tach.ripplePct() ...
+
+#pragma once
+
+#include <Arduino.h>
+
+class TachCapture {
+public:
+  static const uint8_t       TICKS_PER_US = 2;          // clk/8 at 16 MHz
+  static const uint8_t       FILTER_SHIFT = 3;          // average weight 1/8 per period
+  static const unsigned long STOP_US      = 500000UL;   // no edge this long reads as stopped
+
+  TachCapture() : _slot(-1), _ppr(0) {}
+
+  // Claim the timer behind icpPin and start stamping edges. Returns false when the pin has
+  // no input capture unit or its timer is in use.
+  bool begin(uint8_t icpPin, uint16_t pulsesPerRev);
+
+  // Stop capturing and hand the timer back to StepTimer.
+  void end();
+
+  float rps() const;
+  float filteredRPS() const;
+
+  // Start a new ripple window (also restarted by begin()).
+  void  resetRipple();
+  float ripplePct() const;
+  float windowRPS() const;            // mean speed over the ripple window
+
+  // Tach edges since begin(), wrapping.
+  unsigned long pulses() const;
+
+  // Called by the capture ISR stubs in tach_capture.cpp with a 32-bit tick stamp.
+  void onCapture(unsigned long stamp);
+
+private:
+  int8_t   _slot;                     // capture unit / ISR slot; -1 when not running
+  uint16_t _ppr;
+
+  volatile unsigned long _lastStamp, _period, _avgQ4;   // ticks; _avgQ4 in 1/16 tick
+  volatile unsigned long _pulses;
+  volatile unsigned long _winStart, _winMin, _winMax;
+  volatile unsigned long _winCount;   // periods in the ripple window
+  volatile bool          _stamped;    // an edge has been seen since begin()
+
+  // 32-bit tick count now, on the same clock as the stamps.
+  unsigned long nowTicks() const;
+
+  // rev/s for a period, slowed to the time since lastStamp once that is longer.
+  float toRPS(float periodTicks, unsigned long lastStamp) const;
+};
@@ -0,0 +1,157 @@
+// linear_motor.h
+// Linear axis stepper with limit switches and calibration.
+// Extends MotorBase with homing, end-finding, and position-based traversal.
+
+#pragma once
+
+#include "motor_base.h"
+
+class LinearMotor : public MotorBase {
+public:
+  // Extended init — driver plus limit switch pins and axis specs.
+  // mmPerRev: lead-screw pitch (mm/rev); pass 0 to suppress mm output.
+  // maxRPS: operating ceiling used to compute the limit-triggered decel rate.
+  void init(uint8_t id, StepperDriver* driver,
+            int limitEndPin, int limitHomePin, float mmPerRev, float maxRPS);
+
+  // Register FALLING-edge interrupts on limitEndPin and limitHomePin.
+  // Finds a free ISR slot (max 4 LinearMotors). Call before any trapezoidal moves.
+  void enableLimits();
+
+  // Detach interrupts and release the ISR slot.
+  void disableLimits();
+
+  // Live pin read — true when the sensor is currently active (pin LOW).
+  bool atEnd()  const;
+  bool atHome() const;
+
+  // Approach the home sensor (see setHomingSpeed()), back off until clear at slowRPS. Sets
+  // position = 0. Returns the position the axis held at the clear point before the reset:
+  // the steps lost since the last findHome() (0 when none were).
+  long findHome(float slowRPS);
+
+  // Approach the end sensor; the latch is always a slowRPS creep onto it. Records endPos
+  // and axisLength.
+  void findEnd(float slowRPS);
+
+  // Two-speed homing for findHome() / findEnd(): jog toward the sensor at fastRPS, ramped at
+  // accel (rev/s²), and let its limit ISR stop the axis through the limit decel; then latch
+  // the same edge the creep does at slowRPS — the home clear point on the back-off, the end
+  // sensor on a slow re-approach. The overrun is at most setLimitStopRevs(), so the latch
+  // creeps only that far. fastRPS 0 (default): creep the whole way.
+  void setHomingSpeed(float fastRPS, float accel);
+
+  // Full calibration sequence: findHome then findEnd.
+  // Prints axis length in steps, revolutions, and mm over Serial.
+  void calibrate(float slowRPS);
+
+  // Trapezoidal move from current position back to step 0 (home).
+  void goHome(float cruiseRPS);
+
+  // Trapezoidal move from current position to endPos, or to the soft limit short of it.
+  void goToEnd(float cruiseRPS);
+
+  // ── Soft limits from the calibration ──
+  // Soft window (MotorBase::setSoftLimits()) from home to marginRevs short of the end sensor:
+  // 0 is the home sensor's clear point, endPos its first active step, so every planned move
+  // and jog stops before either switch and the limit decel is left for faults. Needs an
+  // axis length (calibrate() or loadCalibration()), and follows every later findEnd() or
+  // loadCalibration(). Homing and the stall trials run with the window off.
+  void enableSoftLimits(float marginRevs);
+  void disableSoftLimits();
+
+  // ── Stall-threshold search ──
+  // One trial runs out travelRevs and back at a given accel (rev/s²) and cruise (rev/s), then
+  // re-homes with findHome(homeRPS). It passes when neither move stopped early (limit, or
+  // stall with attachTach()) and the re-home found the axis within tolSteps of 0. Trials
+  // start and end at home. Defaults: 5 revs, stepsPerRev / 50 steps, 0.5 rev/s.
+  void setStallTrial(float travelRevs, long tolSteps, float homeRPS);
+
+  // Outcome of one trial, classified before the re-home (whose own stop on the home sensor
+  // would read as a limit): a move stopped by the tach or a limit switch, or a clean run
+  // whose re-home error exceeded tolSteps. TRIAL_SKIPPED: travelRevs cannot hold both
+  // ramps (the message says so).
+  enum TrialResult : uint8_t { TRIAL_PASS, TRIAL_LOST, TRIAL_LIMIT, TRIAL_STALL, TRIAL_SKIPPED };
+
+  // Run one trial; errSteps gets the re-home error.
+  TrialResult stallTrial(float accel, float cruiseRPS, long* errSteps = nullptr);
+
+  // Bracket of a search: the highest level that passed and the lowest that failed
+  // (rev/s² or rev/s). passLevel is 0 when even lo failed, failLevel 0 when even hi passed.
+  struct StallLimit {
+    float   passLevel, failLevel;
+    uint8_t runs;
+  };
+  static const uint8_t STALL_MAX_RUNS = 16;
+
+  // Bisect accel (at cruiseRPS) or cruise speed (at accel) between lo and hi: hi first, then
+  // lo, then midpoints until the bracket is narrower than resolution, at most STALL_MAX_RUNS
+  // trials — about log2((hi - lo) / resolution) + 2. Homes first, then prints one CSV row
+  // per trial and the bracket.
+  StallLimit findAccelLimit(float lo, float hi, float cruiseRPS, float resolution);
+  StallLimit findSpeedLimit(float lo, float hi, float accel, float resolution);
+
+  // Highest level that passed in the last findAccelLimit() (rev/s²) / findSpeedLimit()
+  // (rev/s), or as restored by loadCalibration(); 0 = not measured.
+  float accelLimit() const { return _accelLimit; }
+  float speedLimit() const { return _speedLimit; }
+
+  // ── Calibration store (EEPROM, see eeprom_record.h) ──
+  // One record per axis: endPos and axis length, the stall-search limits, and the tuning —
+  // max accel, limit stop distance and resonance bands. The torque curve and maxRPS stay in
+  // the sketch. A record saved at another stepsPerRev is refused (positions are in steps).
+  // Bump CALIB_VERSION when the record changes; older records then read as missing.
+  static const uint8_t CALIB_VERSION = 1;
+  static int calibrationSpan();              // EEPROM bytes per axis record
+
+  bool saveCalibration(int addr);
+
+  // Restore a saved record, replacing the axis length and the tuning set so far. The
+  // position is not stored: home before moving. Returns false (nothing changed) when there
+  // is no valid record at addr.
+  bool loadCalibration(int addr);
+
+  // Boot sequence: restore the record at addr and re-home at slowRPS, or, without a valid
+  // record, run calibrate(slowRPS) and save one. Returns true when the record was used.
+  bool bootCalibrate(int addr, float slowRPS);
+
+  // Axis length after calibration.
+  float axisLengthRevs() const { return (float)_axisLength / _stepsPerRev; }
+  float axisLengthMM()   const { return axisLengthRevs() * _mmPerRev; }
+
+protected:
+  long _endPos, _axisLength;
+
+private:
+  float _trialRevs, _trialHomeRPS;   // stall trial: out-and-back distance, re-home speed
+  long  _trialTol;                   // stall trial: re-home error that still passes (steps)
+  float _accelLimit, _speedLimit;    // last stall-search pass levels; 0 = not measured
+  float _homeFastRPS, _homeAccel;    // two-speed homing approach; 0 = creep only
+  long  _softMargin;                 // soft window's end margin (steps); -1 = off
+
+  // EEPROM layout of saveCalibration(), CALIB_VERSION 1.
+  struct CalibRecord {
+    uint16_t  stepsPerRev;
+    long      endPos, axisLength;
+    float     accelLimit, speedLimit;
+    float     maxAccel, limitStopRevs;
+    SpeedBand bands[MAX_BANDS];
+    uint8_t   bandCount, bandBoost;
+  };
+
+  // Set the soft window from endPos when enabled and the axis is calibrated.
+  void applySoftLimits();
+
+  // Shared bisection of findAccelLimit (speed = false) and findSpeedLimit (speed = true).
+  StallLimit stallSearch(bool speed, float lo, float hi, float other, float resolution);
+
+  // Fast approach of two-speed homing: true when the axis stopped on sensorPin.
+  bool fastApproach(int sensorPin, int8_t dir);
+
+  void creepUntilSensor(int sensorPin, int8_t dir, float rps);
+  void creepUntilSensorClear(int sensorPin, int8_t dir, float rps);
+
+  // Step at rps while sensorPin reads level, one burst at a time. The sensor is sampled
+  // between bursts, so the creep overruns its edge by at most BURST_SPAN_US of travel.
+  void creepWhile(int sensorPin, int level, int8_t dir, float rps);
+};
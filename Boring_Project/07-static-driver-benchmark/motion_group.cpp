@@ -0,0 +1,123 @@
+// motion_group.cpp
+// MotionGroup: coordinated linear moves — a master trapezoid with Bresenham followers.
+
+#include "lib/motor/motion_group.h"
+
+void MotionGroup::init(MotorBase* const* axes, uint8_t count) {
+  _count = (count < MAX_AXES) ? count : MAX_AXES;
+  for (uint8_t i = 0; i < _count; i++) _axes[i] = axes[i];
+  _master      = 0;
+  _masterSteps = 0;
+}
+
+void MotionGroup::moveLinear(const float* revs, float feedRPS, float accel) {
+  if (_count == 0) return;
+  for (uint8_t i = 0; i < _count; i++) _axes[i]->waitDone();   // finish any start… move or jog
+  if (feedRPS <= 0.0f || accel <= 0.0f) {
+    Serial.println("MotionGroup::moveLinear: feedRPS and accel must be positive.");
+    return;
+  }
+
+  // Steps per axis. The master has the most steps; feed applies to the most revolutions.
+  Fixed maxRevs;
+  _master = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    int spr   = _axes[i]->_stepsPerRev;
+    _delta[i] = Fixed::fromFloat(revs[i]).abs().mulInt(spr);
+    Fixed r   = Fixed::ratio(_delta[i], spr);
+    if (r > maxRevs) maxRevs = r;
+    if (_delta[i] > _delta[_master]) _master = i;
+  }
+  MotorBase* master = _axes[_master];
+  int        spr    = master->_stepsPerRev;
+  _masterSteps      = _delta[_master];
+  if (_masterSteps == 0) return;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!_axes[i]->softAllows((revs[i] > 0) ? _delta[i] : -_delta[i], "MotionGroup::moveLinear"))
+      return;
+  }
+
+  // Master speed and accel are the feed values scaled by its share of the longest travel.
+  Fixed masterRevs = Fixed::ratio(_masterSteps, spr);
+  Fixed scale      = masterRevs / maxRevs;
+  Fixed rps        = Fixed::fromFloat(feedRPS) * scale;
+  Fixed a          = Fixed::fromFloat(accel)   * scale;
+  if (rps <= Fixed() || a <= Fixed()) {
+    Serial.println("MotionGroup::moveLinear: feed too low for the master axis.");
+    return;
+  }
+  // The master's resonance bands apply; the followers' speeds scale with it.
+  rps = Fixed::fromFloat(master->snapCruise(rps.toFloat()));
+
+  long rampSteps = (rps * rps / (a * 2)).mulInt(spr);
+  if (2 * rampSteps > _masterSteps) {              // triangle: peak where the ramps meet
+    rampSteps = _masterSteps / 2;
+    rps       = (a * Fixed::ratio(2 * rampSteps, spr)).sqrt();
+  }
+  // a = v² / (2 · ramp revs) on the step-snapped ramp, as in manualTrapMove().
+  if (rampSteps > 0) a = rps * rps / (Fixed::ratio(rampSteps, spr) * 2);
+
+  // Limit stop: the gentlest rate, in master rev/s², that keeps every axis within its own
+  // limit decel. An axis moving rate/share past Q16.16 range is skipped — it stops well
+  // inside its limit at any other axis' rate.
+  Fixed stopRate;
+  for (uint8_t i = 0; i < _count; i++) {
+    Fixed rate = _axes[i]->limitDecelRate();
+    if (rate <= Fixed() || _delta[i] == 0) continue;
+    Fixed share = Fixed::ratio(_delta[i], _axes[i]->_stepsPerRev) / masterRevs;
+    if (share.raw() <= rate.raw() / 32767) continue;
+    rate = rate / share;
+    if (stopRate == Fixed() || rate < stopRate) stopRate = rate;
+  }
+
+  Serial.print("--- Linear Move (master: Motor "); Serial.print(master->_id); Serial.println(") ---");
+  Serial.print("Feed="); Serial.print(feedRPS);
+  Serial.print(" RPS, Accel="); Serial.print(accel);
+  Serial.print(" rev/s², Master steps="); Serial.print(_masterSteps);
+  Serial.print(", Ramp="); Serial.print(rampSteps); Serial.println(" steps");
+
+  for (uint8_t i = 0; i < _count; i++) {
+    _err[i] = _masterSteps / 2;                    // centred: followers step mid-interval
+    if (i == _master) continue;
+    MotorBase* axis = _axes[i];
+    int8_t     dir  = (revs[i] > 0) ? 1 : -1;
+    axis->setDirection(revs[i] > 0);
+    axis->_dir = dir;
+    axis->seedLimitFlag(dir);
+  }
+
+  master->setDirection(revs[_master] > 0);
+  master->planMove(rampSteps, _masterSteps - 2 * rampSteps, rampSteps, rps, a, a,
+                   (revs[_master] > 0) ? 1 : -1);
+  master->setLimitRate(stopRate);
+  master->_group = this;
+  master->runMove();
+  master->_group = nullptr;
+
+  master->reportMove();
+  for (uint8_t i = 0; i < _count; i++) {
+    Serial.print("Motor "); Serial.print(_axes[i]->_id);
+    Serial.print(": Commanded="); Serial.print(_delta[i]);
+    Serial.print(" steps, Position="); Serial.println(_axes[i]->positionSteps());
+  }
+}
+
+// Bresenham: follower i steps _delta[i] times over _masterSteps master steps.
+void MotionGroup::onMasterStep() {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (i == _master) continue;
+    _err[i] += _delta[i];
+    if (_err[i] < _masterSteps) continue;
+    _err[i] -= _masterSteps;
+    MotorBase* axis = _axes[i];
+    axis->_driver->pulse();
+    axis->_position += axis->_dir;
+  }
+}
+
+bool MotionGroup::limitTriggered() {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (i != _master && _axes[i]->limitTriggered()) return true;
+  }
+  return false;
+}
@@ -0,0 +1,126 @@
+// move_queue.cpp
+// MoveQueue: look-ahead junction planning over a buffered run of trapezoid segments.
+
+#include "lib/motor/move_queue.h"
+
+void MoveQueue::init(MotorBase* motor) {
+  _motor = motor;
+  _count = 0;
+  _next  = 0;
+}
+
+bool MoveQueue::add(float revolutions, float cruiseRPS) {
+  if (_count >= MAX_SEGMENTS) {
+    Serial.println("MoveQueue::add: queue full.");
+    return false;
+  }
+  long steps = Fixed::fromFloat(revolutions).abs().mulInt(_motor->_stepsPerRev);
+  if (steps == 0) return false;
+
+  float rps = fabs(cruiseRPS);
+  if (_motor->_maxRPS > 0.0f && rps > _motor->_maxRPS) rps = _motor->_maxRPS;
+  rps = _motor->snapCruise(rps);
+
+  _steps[_count] = steps;
+  _rps[_count]   = Fixed::fromFloat(rps);
+  _dirs[_count]  = (revolutions > 0) ? 1 : -1;
+  _count++;
+  return true;
+}
+
+void MoveQueue::run(float accel) {
+  if (_count == 0) return;
+  MotorBase* m   = _motor;
+  int        spr = m->_stepsPerRev;
+  m->waitDone();                                    // finish any start… move or jog first
+
+  float rate = fabs(accel);
+  if (m->_maxAccel > 0.0f && rate > m->_maxAccel) rate = m->_maxAccel;
+  Fixed a = Fixed::fromFloat(rate);
+  if (a <= Fixed()) {
+    Serial.println("MoveQueue::run: accel must be non-zero.");
+    clear();
+    return;
+  }
+  long offset = 0;                                  // every segment end, against the soft limits
+  for (uint8_t i = 0; i < _count; i++) {
+    offset += _dirs[i] * _steps[i];
+    if (!m->softAllows(offset, "MoveQueue::run")) {
+      clear();
+      return;
+    }
+  }
+
+  // Ramp index of each cruise speed, n = v² / (2a) in steps, and of each junction.
+  // A junction between same-direction segments starts at the lower cruise index; reversals
+  // and both queue ends are at rest.
+  long cruiseN[MAX_SEGMENTS];
+  long junctionN[MAX_SEGMENTS + 1];
+  for (uint8_t i = 0; i < _count; i++) cruiseN[i] = (_rps[i] * _rps[i] / (a * 2)).mulInt(spr);
+  junctionN[0] = junctionN[_count] = 0;
+  for (uint8_t i = 1; i < _count; i++) {
+    junctionN[i] = (_dirs[i] == _dirs[i - 1]) ? min(cruiseN[i - 1], cruiseN[i]) : 0;
+  }
+
+  // Backward pass: every segment must be able to decel to its exit junction.
+  // Forward pass: every segment must be able to accel from its entry junction.
+  for (int i = _count - 1; i >= 0; i--) junctionN[i] = min(junctionN[i], junctionN[i + 1] + _steps[i]);
+  for (uint8_t i = 0; i < _count; i++)  junctionN[i + 1] = min(junctionN[i + 1], junctionN[i] + _steps[i]);
+
+  // Each segment ramps from its entry index up to its cruise index and back down to its
+  // exit index; when that does not fit, the ramps meet at peak index (S + entry + exit) / 2.
+  float expected = 0.0f;
+  for (uint8_t i = 0; i < _count; i++) {
+    long  entryN = junctionN[i], exitN = junctionN[i + 1];
+    long  topN   = cruiseN[i];
+    Fixed rps    = _rps[i];
+    if ((topN - entryN) + (topN - exitN) > _steps[i]) {
+      topN = (_steps[i] + entryN + exitN) / 2;
+      rps  = (a * Fixed::ratio(2 * topN, spr)).sqrt();
+    }
+    long aSteps = topN - entryN;
+    long dSteps = topN - exitN;
+    m->planSegment(_segs[i], aSteps, _steps[i] - aSteps - dSteps, dSteps,
+                   rps, a, a, _dirs[i], entryN, exitN);
+
+    // v(n) = sqrt(2·a·n) → ramp time (v_top - v_n) / a; cruise time steps / v_top.
+    float vTop = rps.toFloat();
+    float vIn  = sqrt(2.0f * rate * entryN / spr);
+    float vOut = sqrt(2.0f * rate * exitN  / spr);
+    expected  += (2.0f * vTop - vIn - vOut) / rate;
+    if (vTop > 0.0f) expected += (float)(_steps[i] - aSteps - dSteps) / (vTop * spr);
+  }
+
+  Serial.print("--- Motor "); Serial.print(m->_id); Serial.println(" Queue Move ---");
+  Serial.print("Segments="); Serial.print(_count);
+  Serial.print(", Accel="); Serial.print(rate); Serial.print(" rev/s², Junctions (RPS):");
+  for (uint8_t i = 0; i <= _count; i++) {
+    Serial.print(" "); Serial.print(sqrt(2.0f * rate * junctionN[i] / spr), 2);
+  }
+  Serial.println();
+
+  m->setDirection(_segs[0].dir > 0);
+  m->beginMove(_segs[0]);
+  _next = 1;
+  m->_queue = this;
+  unsigned long startUs = micros();
+  m->runMove();
+  m->_queue = nullptr;
+  float actual = (micros() - startUs) / 1e6;
+
+  Serial.print("--- Motor "); Serial.print(m->_id); Serial.println(" Queue Complete ---");
+  if (m->_limitHitPhase != MotorBase::PHASE_IDLE) {
+    Serial.print("Limit hit — queue stopped in segment "); Serial.print(_next);
+    Serial.print(" of "); Serial.println(_count);
+  }
+  Serial.print("Position: "); Serial.println(m->positionSteps());
+  Serial.print("Total:  Expected="); Serial.print(expected, 3);
+  Serial.print("s, Actual="); Serial.print(actual, 3); Serial.println("s");
+  clear();
+}
+
+bool MoveQueue::loadNext() {
+  if (_next >= _count) return false;
+  _motor->chainSegment(_segs[_next++]);
+  return true;
+}
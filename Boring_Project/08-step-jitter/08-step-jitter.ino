@@ -0,0 +1,50 @@
+// Step Jitter Probe — per-step period error, per phase, at rising cruise speeds
+// Step/dir driver (STR3): Dir=D30, Step=D31. Runs with or without a motor attached.
+// Each test runs one manualTrapMove per ramp generator (RAMP_AUSTIN, then RAMP_SQRT) with a
+// StepJitter probe attached, then prints the per-phase error table and the worst steps.
+// Results go to Serial at 115200; nothing is printed while a move runs.
+
+#include "lib/driver/stepper/str3.h"
+#include "lib/motor/rotational_motor.h"
+#include "lib/motor/step_jitter.h"
+
+// ── CONFIGURATION ──────────────────────────────────────────────────────────────
+const int   DIR_PIN       = 30;
+const int   STEP_PIN      = 31;
+const int   STEPS_PER_REV = 800;
+const float RAMP_REVS     = 2;     // accel and decel revolutions
+const float CRUISE_REVS   = 5;
+const float SPEEDS_RPS[]  = {5, 10, 20, 40};
+const int   NUM_SPEEDS    = sizeof(SPEEDS_RPS) / sizeof(SPEEDS_RPS[0]);
+// ──────────────────────────────────────────────────────────────────────────────
+
+STR3            driver(DIR_PIN, STEP_PIN, STEPS_PER_REV);   // dirPin, stepPin, stepsPerRev
+RotationalMotor motor;
+StepJitter      jitter;
+
+void runTest(MotorBase::RampMode mode, const char* label, float rps) {
+  Serial.print("=== "); Serial.print(label); Serial.print(" @ ");
+  Serial.print(rps); Serial.println(" RPS ===");
+  motor.setRampMode(mode);
+  jitter.reset();
+  motor.setJitterProbe(&jitter);
+  motor.manualTrapMove(RAMP_REVS, CRUISE_REVS, RAMP_REVS, rps);     // accelRevs, cruiseRevs, decelRevs, cruiseRPS
+  motor.setJitterProbe(nullptr);
+  jitter.report();
+  motor.manualTrapMove(-RAMP_REVS, -CRUISE_REVS, -RAMP_REVS, rps);  // back to the start, unrecorded
+  delay(250);
+}
+
+void setup() {
+  Serial.begin(115200);
+  motor.init(1, &driver);   // id, driver
+
+  Serial.println("=== STEP JITTER PROBE ===");
+  for (int i = 0; i < NUM_SPEEDS; i++) {
+    runTest(MotorBase::RAMP_AUSTIN, "Austin ramp", SPEEDS_RPS[i]);
+    runTest(MotorBase::RAMP_SQRT,   "sqrt ramp",   SPEEDS_RPS[i]);
+  }
+  Serial.println("=== DONE ===");
+}
+
+void loop() {}
@@ -0,0 +1,52 @@
+// step_motor_driver.h
+// Common implementation for Applied Motion step/direction stepper drivers.
+// Handles step pulse generation, direction control, and optional enable pin.
+// Named driver classes (STR3, ST5, ST10) inherit from this.
+// Step and direction pins are written through FastPin (direct port registers).
+
+#pragma once
+
+#include "../stepper_driver.h"
+#include "../gpio/fast_pin.h"
+
+class StepMotorDriver : public StepperDriver {
+public:
+  // dirPin / stepPin: digital output pins for direction and step signals.
+  // enablePin: optional active-HIGH enable pin; pass -1 if unused.
+  // stepsPerRev: microstep-per-revolution setting (matches DIP switches on the unit).
+  // invertDir: true = invert direction pin (compensates for reversed motor wiring).
+  StepMotorDriver(int dirPin, int stepPin, int enablePin,
+                  int stepsPerRev, bool invertDir = false);
+
+  // Set all pins to OUTPUT (and enable pin to OUTPUT if present).
+  void init() override;
+
+  // Toggle step pin: HIGH for stepPeriodUs/2, then LOW for the rest of the period.
+  void step(unsigned long stepPeriodUs) override;
+
+  // step() for each period, in one call.
+  void stepBurst(const unsigned long* periods, uint8_t count) override;
+
+  // Single PULSE_US-wide HIGH pulse on the step pin, no period delay.
+  void pulse() override;
+
+  // Write direction pin, accounting for invertDir.
+  void setDirection(bool forward) override;
+
+  int stepsPerRev() const override { return _stepsPerRev; }
+
+  int stepPin() const override { return _stepPin; }
+
+  // Drive enable pin HIGH / LOW. No-op when enablePin = -1.
+  void enable()  override;
+  void disable() override;
+
+  // Minimum STEP HIGH time accepted by the Applied Motion drivers (µs).
+  static const uint8_t PULSE_US = 5;
+
+protected:
+  int  _dirPin, _stepPin, _enablePin;
+  FastPin _dirOut, _stepOut;     // port/mask resolved once, written every step
+  int  _stepsPerRev;
+  bool _invertDir;
+};
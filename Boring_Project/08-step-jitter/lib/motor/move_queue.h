@@ -0,0 +1,59 @@
+// move_queue.h
+// Look-ahead move queue for one MotorBase axis.
+// Segments are buffered, then planned together. Consecutive segments in the same direction
+// pass their junction at speed (up to the lower of the two cruise speeds) instead of
+// stopping, and reversals stop at zero. The whole queue then runs as one pulse train
+// through the axis' trapezoid generator, timer ISR or blocking loop.
+//
+// Usage:
+//   MoveQueue xQueue;
+//   xQueue.init(&xMotor);
+//   xQueue.add(5, 10);      // revolutions, cruiseRPS
+//   xQueue.add(3, 4);
+//   xQueue.add(-8, 10);
+//   xQueue.run(20);         // accel (rev/s²), shared by every ramp in the queue
+//
+// Cruise speeds are capped at the axis' maxRPS, and accel at its setMaxAccel() ceiling.
+// All segments share one accel, so junction speeds are ramp indices n = v² / (2a) in steps,
+// and the look-ahead passes are integer: a segment of S steps can change n by at most S.
+// A limit hit stops the axis through the normal limit decel and drops the rest of the queue.
+// With soft limits (MotorBase::setSoftLimits()) every segment's end is checked before the
+// run starts; one outside the window drops the queue without moving.
+
+#pragma once
+
+#include <Arduino.h>
+#include "motor_base.h"
+
+class MoveQueue {
+public:
+  static const uint8_t MAX_SEGMENTS = 8;
+
+  void init(MotorBase* motor);
+
+  // Append a relative move of revolutions at cruiseRPS. Returns false when the queue is
+  // full or the move rounds to zero steps.
+  bool add(float revolutions, float cruiseRPS);
+
+  // Drop every queued segment.
+  void clear() { _count = 0; _next = 0; }
+
+  uint8_t size() const { return _count; }
+
+  // Plan junction speeds over the queue and run it to completion. Clears the queue. A move
+  // or jog still running on the axis finishes first.
+  void run(float accel);
+
+  // Called by the generator when a segment's decel ends (possibly in the step timer ISR).
+  // Loads the next pre-planned segment; false when the queue is done.
+  bool loadNext();
+
+private:
+  MotorBase*         _motor;
+  long               _steps[MAX_SEGMENTS];
+  Fixed              _rps[MAX_SEGMENTS];
+  int8_t             _dirs[MAX_SEGMENTS];
+  MotorBase::Segment _segs[MAX_SEGMENTS];   // generator constants, built by run()
+  uint8_t            _count;
+  uint8_t            _next;                 // next segment loadNext() hands out
+};
@@ -0,0 +1,73 @@
+// Tach Ripple Sweep — velocity ripple from the driver tach, across a range of jog speeds
+// Step/dir driver (STR3): Dir=D51, Step=D53 | Tach Out=D48 (ICP5) | LCD: RS=7, EN=8, D4=4, D5=5, D6=6, D7=11
+// At each speed the axis jogs, settles, then the tach is sampled for MEASURE_MS without
+// blocking (TachCapture timestamps every edge in the input-capture unit). Prints one CSV row
+// per speed: commanded rps, filtered tach rps, mean tach rps over the window and the
+// peak-to-peak ripple in % — a resonance shows as a ripple spike (or a stall as 0 rps).
+
+#include <LiquidCrystal.h>
+#include "lib/driver/stepper/str3.h"
+#include "lib/motor/rotational_motor.h"
+#include "lib/driver/timer/tach_capture.h"
+#include "lib/driver/lcd/lcd.h"
+#include "lib/control/display/display.h"
+
+// ── CONFIGURATION ──────────────────────────────────────────────────────────────
+const int      DIR_PIN       = 51;
+const int      STEP_PIN      = 53;
+const int      STEPS_PER_REV = 200;
+const uint8_t  TACH_PIN      = 48;     // ICP5 (or 49 = ICP4)
+const uint16_t TACH_PPR      = 100;    // pulses per rev, as set on the driver
+const float    START_RPS     = 1.0f;
+const float    END_RPS       = 15.0f;
+const float    STEP_RPS      = 0.5f;
+const float    ACCEL         = 20.0f;  // rev/s² between speeds
+const unsigned long SETTLE_MS  = 500;
+const unsigned long MEASURE_MS = 1000;
+// ──────────────────────────────────────────────────────────────────────────────
+
+LiquidCrystal   lcd(7, 8, 4, 5, 6, 11);                       // RS, EN, D4, D5, D6, D7
+STR3            driver(DIR_PIN, STEP_PIN, STEPS_PER_REV);     // dirPin, stepPin, stepsPerRev
+RotationalMotor motor;
+TachCapture     tach;
+
+// Keep the jog running (poll) and the LCD live for ms.
+void runFor(unsigned long ms) {
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    motor.poll();
+    Display::renderTachInfo(tach);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  LCD::init(&lcd);
+  if (!tach.begin(TACH_PIN, TACH_PPR)) {   // before attachStepTimer: the tach takes Timer5
+    LCD::print("No tach capture");
+    while (true) {}
+  }
+  motor.init(1, &driver);   // id, driver
+  motor.attachStepTimer();
+
+  Serial.println("=== TACH RIPPLE SWEEP ===");
+  Serial.println("rps,tach_rps,window_rps,ripple_pct");
+  for (float rps = START_RPS; rps <= END_RPS + 0.001f; rps += STEP_RPS) {
+    motor.setTargetVelocity(rps, ACCEL);   // rps, accel
+    runFor(SETTLE_MS);
+    tach.resetRipple();
+    runFor(MEASURE_MS);
+
+    Serial.print(rps, 2);                Serial.print(",");
+    Serial.print(tach.filteredRPS(), 3); Serial.print(",");
+    Serial.print(tach.windowRPS(), 3);   Serial.print(",");
+    Serial.println(tach.ripplePct(), 2);
+  }
+  motor.setTargetVelocity(0, ACCEL);
+  motor.waitDone();
+  Serial.println("=== DONE ===");
+}
+
+void loop() {
+  Display::renderTachInfo(tach);
+}
@@ -0,0 +1,81 @@
+// display.cpp
+// Motor status rendering — reads motor state via public getters, calls LCD driver primitives.
+
+#include "lib/control/display/display.h"
+#include "lib/motor/motor_base.h"
+#include "lib/motor/linear_motor.h"
+#include "lib/driver/timer/tach_capture.h"
+#include "lib/driver/lcd/lcd.h"
+#include "lib/util/fstr.h"
+
+namespace Display {
+
+// ── Shared row helpers ────────────────────────────────────────────────────────
+// Rows are built in a buffer wide enough for the longest fstr() value (11 chars) plus the
+// label, then cut and padded to the 16 LCD columns by printRow().
+
+static const uint8_t ROW_BUF = 32;
+
+// Print text on row, padded or cut to the full 16 columns.
+static void printRow(uint8_t row, const char* text) {
+  char line[17];
+  snprintf(line, sizeof(line), "%-16.16s", text);
+  LCD::setCursor(0, row);
+  LCD::print(line);
+}
+
+static void renderPositionRow(MotorBase& m) {
+  char text[ROW_BUF];
+  if (m.mmPerRev() > 0.0f) {
+    snprintf(text, sizeof(text), "M%d Pos:%smm", m.id(), fstr(m.positionRevs() * m.mmPerRev(), 1));
+  } else {
+    snprintf(text, sizeof(text), "M%d Pos:%srev", m.id(), fstr(m.positionRevs(), 2));
+  }
+  printRow(0, text);
+}
+
+// ── MotorBase overload ────────────────────────────────────────────────────────
+
+void renderMotorInfo(MotorBase& m) {
+  static unsigned long lastUpdate = 0;
+  if (micros() - lastUpdate < 100000) return;
+  lastUpdate = micros();
+
+  renderPositionRow(m);
+  LCD::setCursor(0, 1);
+  LCD::print("  Motor Only    ");
+}
+
+// ── LinearMotor overload ──────────────────────────────────────────────────────
+
+void renderMotorInfo(LinearMotor& m) {
+  static unsigned long lastUpdate = 0;
+  if (micros() - lastUpdate < 100000) return;
+  lastUpdate = micros();
+
+  renderPositionRow(m);
+
+  LCD::setCursor(0, 1);
+  bool end  = m.atEnd();
+  bool home = m.atHome();
+  if      (end && home) LCD::print("!!BOTH LIMITS!! ");
+  else if (end)         LCD::print("** END  LIMIT **");
+  else if (home)        LCD::print("** HOME LIMIT **");
+  else                  LCD::print("   Status: OK   ");
+}
+
+// ── Tach ──────────────────────────────────────────────────────────────────────
+
+void renderTachInfo(const TachCapture& t) {
+  static unsigned long lastUpdate = 0;
+  if (micros() - lastUpdate < 100000) return;
+  lastUpdate = micros();
+
+  char text[ROW_BUF];
+  snprintf(text, sizeof(text), "Tach %s RPS", fstr(t.filteredRPS(), 2));
+  printRow(0, text);
+  snprintf(text, sizeof(text), "Ripple %s%%", fstr(t.ripplePct(), 2));
+  printRow(1, text);
+}
+
+} // namespace Display
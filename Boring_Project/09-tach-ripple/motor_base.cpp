@@ -0,0 +1,1412 @@
+// motor_base.cpp
+// MotorBase: axis init and trapezoidal motion profile engine.
+// All hardware pin access is delegated to the StepperDriver.
+
+#include <util/atomic.h>
+#include "lib/motor/motor_base.h"
+#include "lib/motor/motion_group.h"
+#include "lib/motor/move_queue.h"
+#include "lib/driver/timer/step_timer.h"
+
+// ── Austin ramp constants ─────────────────────────────────────────────────────
+// Ramp periods are held in Q20.12 µs: 0.24 ns resolution keeps the per-step delta from
+// rounding to zero on long, gentle ramps, and 1 s (the 1 step/s floor) still fits in 32 bits.
+static const uint8_t       RAMP_Q_BITS      = 12;
+static const unsigned long RAMP_Q_ONE       = 1UL << RAMP_Q_BITS;
+static const unsigned long RAMP_Q_MAX       = 1000000UL << RAMP_Q_BITS;   // 1 s
+static const long          RAMP_EXACT_STEPS = 3;   // n <= 3 is exact: periods are long there
+static const long          JOG_STEPS        = 0x3FFFFFFFL;   // jog target distance: unreachable
+
+// 1/sqrt(n) in Q0.16 for the exact ramp steps: T_n = T_1 / sqrt(n).
+static const uint16_t INV_SQRT_Q16[RAMP_EXACT_STEPS + 1] = {0, 0, 46341, 37837};
+
+static inline unsigned long qToUs(unsigned long q) {
+  return (q + RAMP_Q_ONE / 2) >> RAMP_Q_BITS;
+}
+
+// q · k / 2^16 in two 32-bit multiplies (no 64-bit math in the ISR).
+static inline unsigned long scaleQ16(unsigned long q, uint16_t k) {
+  return (q >> 16) * k + (((q & 0xFFFFUL) * k) >> 16);
+}
+
+// Q20.12 period of a speed in rev/s: 1e6 / (rps · stepsPerRev). 0 when not moving.
+// Planning only — one 64-bit divide.
+static unsigned long speedPeriodQ(Fixed rps, int stepsPerRev) {
+  if (rps <= Fixed()) return 0;
+  uint64_t q = ((uint64_t)RAMP_Q_MAX << Fixed::FRAC_BITS) / ((uint64_t)rps.raw() * stepsPerRev);
+  return (q > RAMP_Q_MAX) ? RAMP_Q_MAX : (unsigned long)q;
+}
+
+// Q20.12 period of ramp index n at accel rev/s²: 1e6 / sqrt(2 · a · stepsPerRev · n).
+// sqrt(raw · 2^-16) = sqrt(raw) / 2^8, hence the 8-bit pre-shift. Planning only.
+static unsigned long rampPeriodQ(Fixed accel, int stepsPerRev, unsigned long n) {
+  if (accel <= Fixed() || n == 0) return RAMP_Q_MAX;
+  uint32_t root = isqrt64(2ULL * (uint64_t)accel.raw() * stepsPerRev * n);
+  if (root == 0) return RAMP_Q_MAX;
+  uint64_t q = ((uint64_t)RAMP_Q_MAX << 8) / root;
+  return (q > RAMP_Q_MAX) ? RAMP_Q_MAX : (unsigned long)q;
+}
+
+// T_n for n <= RAMP_EXACT_STEPS from the ramp's T_1.
+static inline unsigned long exactPeriodQ(unsigned long t1Q, long n) {
+  return (n <= 1) ? t1Q : scaleQ16(t1Q, INV_SQRT_Q16[n]);
+}
+
+// Ramp index of the speed stepping at periodUs on a ramp with index-1 period t1Q:
+// n = v² / (2a) = (T_1 / T)², taken as a Q8 period ratio. All 32-bit — ISR-safe.
+static long rampIndexAt(unsigned long t1Q, unsigned long periodUs) {
+  unsigned long period = (periodUs && periodUs < 1000000UL) ? periodUs : 1000000UL;
+  unsigned long ratio  = t1Q / ((period << RAMP_Q_BITS) >> 8);   // T_1 / T in Q8
+  return (ratio < 0x10000UL) ? (long)((ratio * ratio) >> 16)
+                             : (long)((ratio >> 8) * (ratio >> 8));
+}
+
+// T_n = T_1 / sqrt(n) for any n >= 1 in 32-bit math: one isqrt32 and three divides.
+static unsigned long rampSeedQ(unsigned long t1Q, long n) {
+  unsigned long root = (n < 0x10000L) ? isqrt32((unsigned long)n << 16)
+                                      : (unsigned long)isqrt32(n) << 8;
+  return ((t1Q / root) << 8) + (((t1Q % root) << 8) / root);   // T_1 · 2^8 / root
+}
+
+// 2·t / div with the remainder carried into the next step (as in Atmel AVR446), so deltas
+// below one LSB still accumulate exactly on long ramps. One divide: quotient and remainder
+// share a single __udivmodsi4 call. Written as 2·(t / div) to keep 2·t from overflowing.
+static inline unsigned long austinDelta(unsigned long t, unsigned long div, unsigned long& rem) {
+  unsigned long q     = t / div;
+  unsigned long inner = 2 * (t % div) + rem;
+  q *= 2;
+  while (inner >= div) { inner -= div; q++; }
+  rem = inner;
+  return q;
+}
+
+// ── Tach ISR slot table ───────────────────────────────────────────────────────
+// One FALLING-edge stub per slot, as for the LinearMotor limit switches.
+
+namespace {
+
+  static MotorBase* _tachMotors[MotorBase::TACH_SLOTS] = {nullptr, nullptr, nullptr, nullptr};
+
+  static void tachISR0() { if (_tachMotors[0]) _tachMotors[0]->countTachPulse(); }
+  static void tachISR1() { if (_tachMotors[1]) _tachMotors[1]->countTachPulse(); }
+  static void tachISR2() { if (_tachMotors[2]) _tachMotors[2]->countTachPulse(); }
+  static void tachISR3() { if (_tachMotors[3]) _tachMotors[3]->countTachPulse(); }
+
+  typedef void (*IsrFunc)();
+  static const IsrFunc tachISRs[MotorBase::TACH_SLOTS] = {tachISR0, tachISR1, tachISR2, tachISR3};
+
+} // anonymous namespace
+
+// ── Init / direction ──────────────────────────────────────────────────────────
+
+void MotorBase::init(uint8_t id, StepperDriver* driver) {
+  _id            = id;
+  _driver        = driver;
+  _stepsPerRev   = driver->stepsPerRev();   // cache for fast loop access
+  _hasLimits     = false;
+  _limitEndPin   = -1;
+  _limitHomePin  = -1;
+  _mmPerRev      = 0.0f;
+  _maxRPS        = 0.0f;
+  _maxAccel      = 0.0f;
+  _limitStopRevs = 2.0f;
+  _softLimits    = false;
+  _softMin       = 0;
+  _softMax       = 0;
+  _position      = 0;
+  _movingForward = true;
+  _limitEndFlag  = false;
+  _limitHomeFlag = false;
+  _phase         = PHASE_IDLE;
+  _limitHitPhase = PHASE_IDLE;
+  _periodUs      = 0;
+  _rampMode      = RAMP_AUSTIN;
+  _group         = nullptr;
+  _queue         = nullptr;
+  _timerSlot     = -1;
+  _hwPulse       = false;
+  _busy          = false;
+  _doneEvent     = false;
+  _reportPending = false;
+  _doneCallback  = nullptr;
+  _moveStartPos  = 0;
+  _moveTarget    = 0;
+  _chainPending  = false;
+  _jog           = false;
+  _stepLoop      = nullptr;
+  _jitter        = nullptr;
+  _tachPin       = -1;
+  _tachPPR       = 0;
+  _tachPulses    = 0;
+  _tachTotal     = 0;
+  _stalled       = false;
+  _bandCount     = 0;
+  _bandBoost     = 1;
+  _bandSkip      = 0;
+  _rampUs        = 0;
+  _torque        = nullptr;
+  _curveRun      = nullptr;
+  _curveZone     = 0;
+
+  driver->init();
+}
+
+void MotorBase::setDirection(bool forward) {
+  _movingForward = forward;
+  _driver->setDirection(forward);
+}
+
+// ── Step timer ────────────────────────────────────────────────────────────────
+
+bool MotorBase::attachStepTimer() {
+  if (_timerSlot >= 0) return true;
+  _timerSlot = StepTimer::attach(this);
+  if (_timerSlot < 0) {
+    Serial.println("MotorBase::attachStepTimer: no free step timer.");
+    return false;
+  }
+  Serial.print("MotorBase: step timer attached for motor "); Serial.print(_id);
+  Serial.print(" (slot "); Serial.print(_timerSlot); Serial.println(")");
+  return true;
+}
+
+bool MotorBase::attachPulseTimer() {
+  if (_timerSlot >= 0) {
+    if (_hwPulse) return true;
+    Serial.println("MotorBase::attachPulseTimer: detach the step timer first.");
+    return false;
+  }
+  int pin = _driver->stepPin();
+  if (pin >= 0) _timerSlot = StepTimer::attachPulse(this, pin);
+  if (_timerSlot < 0) {
+    Serial.println("MotorBase::attachPulseTimer: step pin is not a free timer output.");
+    return false;
+  }
+  _hwPulse = true;
+  Serial.print("MotorBase: pulse timer attached for motor "); Serial.print(_id);
+  Serial.print(" (slot "); Serial.print(_timerSlot);
+  Serial.print(", pin D"); Serial.print(pin); Serial.println(")");
+  return true;
+}
+
+void MotorBase::detachStepTimer() {
+  if (_timerSlot < 0) return;
+  while (_busy) StepTimer::service();
+  StepTimer::detach(_timerSlot);
+  _timerSlot = -1;
+  _hwPulse   = false;
+}
+
+// ── Tach ──────────────────────────────────────────────────────────────────────
+
+bool MotorBase::attachTach(int tachPin, uint16_t pulsesPerRev, float maxLagRevs) {
+  detachTach();
+  if (tachPin < 0 || pulsesPerRev == 0) {
+    Serial.println("MotorBase::attachTach: needs a tach pin and pulses per rev.");
+    return false;
+  }
+  int slot = -1;
+  for (int i = 0; i < TACH_SLOTS; i++) {
+    if (_tachMotors[i] == nullptr) { slot = i; break; }
+  }
+  if (slot < 0) {
+    Serial.println("MotorBase::attachTach: no free ISR slots.");
+    return false;
+  }
+
+  _tachPin    = tachPin;
+  _tachPPR    = pulsesPerRev;
+  _tachLagMax = Fixed::fromFloat(fabs(maxLagRevs)).mulInt((long)_stepsPerRev * pulsesPerRev);
+  _tachMotors[slot] = this;
+  pinMode(tachPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(tachPin), tachISRs[slot], FALLING);
+
+  Serial.print("MotorBase: tach attached for motor "); Serial.print(_id);
+  Serial.print(" (slot "); Serial.print(slot); Serial.println(")");
+  return true;
+}
+
+void MotorBase::detachTach() {
+  for (int i = 0; i < TACH_SLOTS; i++) {
+    if (_tachMotors[i] == this) {
+      detachInterrupt(digitalPinToInterrupt(_tachPin));
+      _tachMotors[i] = nullptr;
+    }
+  }
+  _tachPin = -1;
+}
+
+float MotorBase::tachRevs() const {
+  if (_tachPPR == 0) return 0.0f;
+  unsigned long pulses;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { pulses = _tachTotal + (uint8_t)(_tachPulses - _tachSeen); }
+  return (float)pulses / _tachPPR;
+}
+
+// Runs once per generated step. In a burst the generator runs up to STEP_BURST steps ahead
+// of _position, so the balance trails by at most one burst. A tach running ahead (the load
+// coasting) banks no more than _tachLagMax of credit.
+bool MotorBase::tachStalled() {
+  uint8_t pulses = _tachPulses - _tachSeen;
+  long    moved  = _position - _tachPos;
+  _tachSeen  += pulses;
+  _tachPos   += moved;
+  _tachTotal += pulses;
+  if (moved < 0) moved = -moved;
+  if (moved)  _tachBalance += moved * _tachPPR;
+  if (pulses) _tachBalance -= (long)pulses * _stepsPerRev;
+  if (_tachBalance < -_tachLagMax) _tachBalance = -_tachLagMax;
+  return _tachBalance > _tachLagMax;
+}
+
+// ── Resonance bands ───────────────────────────────────────────────────────────
+
+bool MotorBase::setResonanceBands(const SpeedBand* bands, uint8_t count, uint8_t boost) {
+  if (count > MAX_BANDS || boost == 0) {
+    Serial.println("MotorBase::setResonanceBands: up to MAX_BANDS bands, boost at least 1.");
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (bands[i].loRPS <= 0.0f || bands[i].hiRPS <= bands[i].loRPS) {
+      Serial.println("MotorBase::setResonanceBands: each band needs 0 < loRPS < hiRPS.");
+      return false;
+    }
+  }
+  // Written with the generator stopped, so a running ramp never sees a half-set table.
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (uint8_t i = 0; i < count; i++) {
+      _bands[i]      = bands[i];
+      _bandFastUs[i] = (unsigned long)(1000000.0f / (bands[i].hiRPS * _stepsPerRev) + 0.5f);
+      _bandSlowUs[i] = (unsigned long)(1000000.0f / (bands[i].loRPS * _stepsPerRev) + 0.5f);
+    }
+    _bandCount = count;
+    _bandBoost = boost;
+  }
+  return true;
+}
+
+uint8_t MotorBase::resonanceBands(SpeedBand* bands, uint8_t* boost) const {
+  for (uint8_t i = 0; i < _bandCount; i++) bands[i] = _bands[i];
+  if (boost) *boost = _bandBoost;
+  return _bandCount;
+}
+
+// Snapping to one edge can land inside an overlapping band, so repeat until clear.
+float MotorBase::safeSpeed(float rps) const {
+  float speed = fabs(rps);
+  for (uint8_t pass = 0; pass < MAX_BANDS; pass++) {
+    bool moved = false;
+    for (uint8_t i = 0; i < _bandCount; i++) {
+      const SpeedBand& b = _bands[i];
+      if (speed <= b.loRPS || speed >= b.hiRPS) continue;
+      bool up = (speed - b.loRPS > b.hiRPS - speed) && (_maxRPS <= 0.0f || b.hiRPS <= _maxRPS);
+      speed   = up ? b.hiRPS : b.loRPS;
+      moved   = true;
+    }
+    if (!moved) break;
+  }
+  return (rps < 0.0f) ? -speed : speed;
+}
+
+float MotorBase::snapCruise(float rps) const {
+  float safe = safeSpeed(rps);
+  if (safe != rps) {
+    Serial.print("MotorBase: "); Serial.print(rps);
+    Serial.print(" RPS is in a resonance band, cruising at "); Serial.print(safe);
+    Serial.println(" RPS.");
+  }
+  return safe;
+}
+
+uint8_t MotorBase::bandStride(long limit) const {
+  for (uint8_t i = 0; i < _bandCount; i++) {
+    if (_rampUs > _bandFastUs[i] && _rampUs < _bandSlowUs[i])
+      return (limit < _bandBoost) ? (limit > 1 ? (uint8_t)limit : 1) : _bandBoost;
+  }
+  return 1;
+}
+
+// ── Torque curve ──────────────────────────────────────────────────────────────
+// Zone k runs a constant-accel ramp a_k from its lower edge v_k. Ramp step c from rest falls
+// in the last zone with startStep < c, at index n = c - startStep + startN of that zone's
+// ramp (v² = 2·a_k·n). startN is the index of v_k at a_k, and startStep adds up the zones
+// below: each covers the indices from its own startN to that of the next edge at its accel.
+
+bool MotorBase::setTorqueCurve(TorqueCurve* curve) {
+  if (_curveRun) waitDone();
+  if (!curve) { _torque = nullptr; return true; }
+  if (curve->_pointCount == 0) {
+    Serial.println("MotorBase::setTorqueCurve: the curve has no points (TorqueCurve::init).");
+    return false;
+  }
+  const TorqueCurve::Point* p = curve->_points;
+  TorqueCurve::Zone*        z = curve->_zones;
+  uint8_t m = curve->_pointCount, k = 0;
+  if (p[0].rps > 0.0f) { z[k].loRPS = 0.0f; z[k++].accel = Fixed::fromFloat(p[0].accel); }
+  for (uint8_t i = 0; i + 1 < m; i++) {
+    z[k].loRPS   = p[i].rps;
+    z[k++].accel = Fixed::fromFloat(min(p[i].accel, p[i + 1].accel));
+  }
+  z[k].loRPS   = p[m - 1].rps;
+  z[k++].accel = Fixed::fromFloat(p[m - 1].accel);
+
+  long step = 0;
+  for (uint8_t i = 0; i < k; i++) {
+    Fixed lo = Fixed::fromFloat(z[i].loRPS);
+    if (i > 0) step += (lo * lo / (z[i - 1].accel * 2)).mulInt(_stepsPerRev) - z[i - 1].startN;
+    z[i].t1Q       = rampPeriodQ(z[i].accel, _stepsPerRev, 1);
+    z[i].startStep = step;
+    z[i].startN    = (lo * lo / (z[i].accel * 2)).mulInt(_stepsPerRev);
+  }
+  curve->_zoneCount = k;
+  _torque = curve;
+  return true;
+}
+
+long MotorBase::curveSteps(Fixed rps) const {
+  const TorqueCurve::Zone* z = _torque->_zones;
+  uint8_t k = _torque->_zoneCount - 1;
+  while (k > 0 && Fixed::fromFloat(z[k].loRPS) >= rps) k--;
+  return z[k].startStep + (rps * rps / (z[k].accel * 2)).mulInt(_stepsPerRev) - z[k].startN;
+}
+
+uint8_t MotorBase::curveZoneOf(long count) const {
+  uint8_t k = _torque->_zoneCount - 1;
+  while (k > 0 && _torque->_zones[k].startStep >= count) k--;
+  return k;
+}
+
+Fixed MotorBase::curveSpeedAt(long count) const {
+  const TorqueCurve::Zone& z = _torque->_zones[curveZoneOf(count)];
+  return (z.accel * Fixed::ratio(2 * (count - z.startStep + z.startN), _stepsPerRev)).sqrt();
+}
+
+float MotorBase::curveTime(float rps) const {
+  const TorqueCurve::Zone* z = _torque->_zones;
+  float t = 0.0f;
+  for (uint8_t k = 0; k < _torque->_zoneCount && z[k].loRPS < rps; k++) {
+    float hi = (k + 1 < _torque->_zoneCount) ? min(rps, z[k + 1].loRPS) : rps;
+    t += (hi - z[k].loRPS) / z[k].accel.toFloat();
+  }
+  return t;
+}
+
+// Runs per ramp step, possibly in the ISR: the zone moves at most one edge per step unless
+// a zone is shorter than a band stride, so the loops are nearly always one compare.
+long MotorBase::curveIndex(long count, bool& edge) {
+  const TorqueCurve::Zone* z = _curveRun->_zones;
+  uint8_t k = _curveZone;
+  while (k + 1 < _curveRun->_zoneCount && count > z[k + 1].startStep) k++;
+  while (k > 0 && count <= z[k].startStep) k--;
+  edge = (k != _curveZone || _curveRate.t1Q == 0);
+  if (edge) {
+    _curveZone       = k;
+    _curveRate.accel = z[k].accel;
+    _curveRate.t1Q   = z[k].t1Q;
+  }
+  return count - z[k].startStep + z[k].startN;
+}
+
+// The edge index is rounded to a whole step, and the recurrence would carry that error on
+// through the zone, so a zone change reseeds the period at its exact value (32-bit math).
+unsigned long MotorBase::curveUp(long count, bool first, uint8_t stride) {
+  bool edge;
+  long n = curveIndex(count, edge);
+  unsigned long seedQ = edge ? rampSeedQ(_curveRate.t1Q, n) : _accelSeedQ;
+  return rampUp(_curveRate, n, seedQ, first || edge, stride);
+}
+
+unsigned long MotorBase::curveDown(long count, bool first, uint8_t stride) {
+  bool edge;
+  long n = curveIndex(count, edge);
+  unsigned long seedQ = first ? _decelSeedQ : edge ? rampSeedQ(_curveRate.t1Q, n) : 0;
+  return rampDown(_curveRate, n, seedQ, first || edge, stride);
+}
+
+// Pulse first so the edge lands at a fixed latency after the compare match;
+// the next period is computed afterwards, in the time the step itself lasts.
+// In hardware pulse mode the match itself made the edge: the ISR books the step, plans the
+// next one, then clears the pin and arms the next match only if it is a step.
+void MotorBase::onStepTimer() {
+  if (_timerTicksLeft > 0) {
+    _timerTicksLeft = StepTimer::load(_timerSlot, _timerTicksLeft);
+    if (_hwPulse) StepTimer::armPulse(_timerSlot, _timerTicksLeft == 0 && _nextPeriodUs != 0);
+    return;
+  }
+  if (_nextPeriodUs == 0) {
+    StepTimer::stop(_timerSlot);
+    finishMove();
+    return;
+  }
+  _timerTicksLeft = StepTimer::load(_timerSlot, _nextPeriodUs * StepTimer::TICKS_PER_US);
+  emitStep();
+  if (_hwPulse) StepTimer::endPulse(_timerSlot, _timerTicksLeft == 0 && _nextPeriodUs != 0);
+}
+
+void MotorBase::groupStep() {
+  _group->onMasterStep();
+}
+
+void MotorBase::emitStep() {
+  if (!_hwPulse) _driver->pulse();
+  _position += _dir;
+  if (_group) _group->onMasterStep();
+  _periodUs  = _nextPeriodUs;
+  markPhase(_nextPhase);
+  if (_jitter) _jitter->record(_nextPhase, _periodUs, micros());
+
+  _nextPeriodUs = nextStepPeriod();
+  _nextPhase    = _genPhase;
+}
+
+// ── Non-blocking moves ────────────────────────────────────────────────────────
+
+// Without a step timer each due step is emitted here, timed against micros(). A late
+// poll() stretches the current period instead of bursting steps to catch up.
+bool MotorBase::poll() {
+  if (_timerSlot >= 0) {
+    StepTimer::service();
+  } else if (_busy) {
+    unsigned long now = micros();
+    if ((long)(now - _pollDueUs) >= 0) {
+      if (_nextPeriodUs == 0) {
+        finishMove();
+      } else {
+        _pollDueUs += _nextPeriodUs;
+        emitStep();
+        if ((long)(now - _pollDueUs) > 0) _pollDueUs = now;
+      }
+    }
+  }
+  if (_doneEvent) completeMove();
+  return _busy;
+}
+
+// Without a timer the rest of the move runs in the delay-timed step loop, picking up at
+// the step poll() would emit next.
+void MotorBase::waitDone() {
+  if (_timerSlot >= 0) {
+    while (_busy) StepTimer::service();
+  } else if (_busy) {
+    long early = (long)(_pollDueUs - micros());
+    if (early > 0) delayMicroseconds(early);
+    if (_stepLoop) _stepLoop(*this);
+    else           runStepLoop(*_driver);
+    finishMove();
+  }
+  if (_doneEvent) completeMove();
+}
+
+// Measured as distance to go, so a retarget restarts it from the retarget point and an
+// overshoot before a reversal reads 0.
+float MotorBase::progress() const {
+  long total = labs(_moveTarget - _moveStartPos);
+  if (total == 0) return 1.0f;
+  long left = labs(_moveTarget - positionSteps());
+  return (left >= total) ? 0.0f : 1.0f - (float)left / total;
+}
+
+void MotorBase::completeMove() {
+  _doneEvent = false;
+  if (_reportPending) {
+    _reportPending = false;
+    reportMove();
+  }
+  if (_doneCallback) _doneCallback(*this);
+}
+
+// ── Retargeting ───────────────────────────────────────────────────────────────
+
+bool MotorBase::retarget(float targetRevs, float cruiseRPS) {
+  if (!_busy) return false;
+  if (_accelRamp.accel <= Fixed() || _decelRamp.accel <= Fixed()) {
+    Serial.println("MotorBase::retarget: constant-speed moves cannot be retargeted.");
+    return false;
+  }
+  if (cruiseRPS == 0.0f) {
+    Serial.println("MotorBase::retarget: cruiseRPS must be non-zero.");
+    return false;
+  }
+  long target = Fixed::fromFloat(targetRevs).mulInt(_stepsPerRev);
+  if (!softAllows(target - positionSteps(), "MotorBase::retarget")) return false;
+  if (!replan(target, cruiseRPS, _accelRamp.accel, _decelRamp.accel, false)) return false;
+
+  Serial.print("--- Motor "); Serial.print(_id); Serial.println(" Retarget ---");
+  Serial.print("Target="); Serial.print(targetRevs, 3);
+  Serial.print(" rev, RPS="); Serial.println(_cruiseRPS.toFloat());
+  return true;
+}
+
+bool MotorBase::retargetSpeed(float cruiseRPS) {
+  if (!_busy || _accelRamp.accel <= Fixed() || _decelRamp.accel <= Fixed() || cruiseRPS == 0.0f)
+    return false;
+  return replan(_moveTarget, cruiseRPS, _accelRamp.accel, _decelRamp.accel, _jog);
+}
+
+// ── Velocity (jog) mode ───────────────────────────────────────────────────────
+// A jog is a retarget toward a target JOG_STEPS away whose cruise never counts down, so every
+// speed change — including a stop or a reversal — goes through the same replan as retarget().
+
+bool MotorBase::setTargetVelocity(float rps, float accel) {
+  float rate = fabs(accel);
+  if (_maxAccel > 0.0f && rate > _maxAccel) rate = _maxAccel;
+  Fixed a = Fixed::fromFloat(rate);
+  if (a <= Fixed()) {
+    Serial.println("MotorBase::setTargetVelocity: accel must be non-zero.");
+    return false;
+  }
+  int8_t dir = (rps > 0) ? 1 : -1;
+
+  if (_busy) {
+    long steps = jogSteps(dir);
+    if (replan(positionSteps() + dir * steps, rps, a, a, steps == JOG_STEPS)) return true;
+    if (_limitHitPhase != PHASE_IDLE) return false;   // stopping on a limit: retry once stopped
+    waitDone();                                        // last step of a finishing move
+  }
+  long steps = jogSteps(dir);
+  if (rps == 0.0f || steps <= 0) return true;         // stopped, or at the soft limit ahead
+
+  ReplanRates r;
+  replanRates(r, rps, a, a);
+  Segment seg;
+  replanSegment(seg, steps, 0, dir, r);
+  setDirection(dir > 0);
+  beginMove(seg);
+  _jog = (steps == JOG_STEPS);
+  startRun();
+  return true;
+}
+
+// Inside a soft window a jog is a move to the edge ahead, so it ramps down in time for it.
+long MotorBase::jogSteps(int8_t dir) const {
+  if (!_softLimits) return JOG_STEPS;
+  long edge = (((dir > 0) ? _softMax : _softMin) - positionSteps()) * dir;
+  return min(edge, JOG_STEPS);
+}
+
+void MotorBase::replanRates(ReplanRates& r, float cruiseRPS, Fixed accel, Fixed decel) const {
+  float rate = fabs(cruiseRPS);
+  if (_maxRPS > 0.0f && rate > _maxRPS) rate = _maxRPS;
+  Fixed rps = Fixed::fromFloat(safeSpeed(rate));
+
+  r.accelRamp.accel = accel;
+  r.accelRamp.t1Q   = rampPeriodQ(accel, _stepsPerRev, 1);
+  r.decelRamp.accel = decel;
+  r.decelRamp.t1Q   = rampPeriodQ(decel, _stepsPerRev, 1);
+  r.cruiseRPS       = rps;
+  r.cruiseQ         = speedPeriodQ(rps, _stepsPerRev);
+  r.cruiseAccelN    = (rps * rps / (accel * 2)).mulInt(_stepsPerRev);
+  r.cruiseDecelN    = (rps * rps / (decel * 2)).mulInt(_stepsPerRev);
+  r.peakShare       = decel / (accel + decel);
+}
+
+// The new plan takes over at the next pulse, from the speed of the running step period.
+// Rates and cruise indices are derived first; the part that depends on position and speed
+// is integer-only (replanFrom) and runs with interrupts off, so no step can fall between
+// the snapshot and the switch.
+bool MotorBase::replan(long target, float cruiseRPS, Fixed accel, Fixed decel, bool jog) {
+  ReplanRates r;
+  replanRates(r, cruiseRPS, accel, decel);
+  bool ok = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ok = replanFrom(target, r, jog); }
+  return ok;
+}
+
+// A zero cruise speed stops the axis at the decel rate. Otherwise three cases, all in steps
+// along the current direction (togo) against the stop distance nD:
+//   togo >= nD, at or below cruise:  one trapezoid from the current speed to rest;
+//   togo >= nD, above cruise:        decel to cruise, then cruise and stop;
+//   togo <  nD:                      stop (overshooting), then a trapezoid back from rest.
+bool MotorBase::replanFrom(long target, const ReplanRates& r, bool jog) {
+  if (_nextPeriodUs == 0 || _phase == PHASE_LIMIT || _limitHitPhase != PHASE_IDLE) return false;
+
+  long nA   = rampIndexAt(r.accelRamp.t1Q, _periodUs);
+  long nD   = rampIndexAt(r.decelRamp.t1Q, _periodUs);
+  long togo = (target - _position) * _dir;
+
+  Segment first;
+  long    slow = nD - r.cruiseDecelN;
+  if (r.cruiseQ == 0) {
+    replanSegment(first, nD, 0, _dir, r, 0);
+    _chainPending = false;
+    target        = _position + _dir * nD;
+  } else if (togo >= nD && (nA <= r.cruiseAccelN || slow <= 0)) {
+    replanSegment(first, togo, nA, _dir, r);
+    _chainPending = false;
+  } else if (togo >= nD) {
+    replanSegment(first, slow, 0, _dir, r, r.cruiseDecelN);
+    replanSegment(_chainSeg, togo - slow, r.cruiseAccelN, _dir, r);
+    _chainPending = true;
+  } else {
+    replanSegment(_chainSeg, nD - togo, 0, -_dir, r);
+    _chainPending = (_chainSeg.accelSteps + _chainSeg.cruiseSteps + _chainSeg.decelSteps > 0);
+    if (nD > 0) {
+      replanSegment(first, nD, 0, _dir, r, 0);
+    } else {
+      first          = _chainSeg;             // already at rest: reverse at once
+      _chainPending  = false;
+    }
+  }
+
+  _rampTable     = nullptr;
+  _sCurve        = false;
+  _curveRun      = nullptr;
+  _jog           = jog;
+  _reportPending = false;                     // the planned phase times no longer apply
+  chainSegment(first);
+  _nextPeriodUs  = nextStepPeriod();
+  _nextPhase     = _genPhase;
+  _moveStartPos  = _position;
+  _moveTarget    = target;
+  if (_hwPulse && _timerTicksLeft == 0) StepTimer::armPulse(_timerSlot, _nextPeriodUs != 0);
+  return true;
+}
+
+// With exitN < 0 (default): a trapezoid over steps from ramp index entryN (accel units) to
+// rest, cruising at the replan speed, or a triangle peaking where the ramps meet,
+// a·(entryN + up) = d·down. With exitN >= 0: a plain decel of steps down to index exitN
+// (decel units). Seeds come from the ramps' T_1 in 32-bit math.
+void MotorBase::replanSegment(Segment& seg, long steps, long entryN, int8_t dir,
+                              const ReplanRates& r, long exitN) const {
+  long          up = 0, down = steps;
+  unsigned long cruiseQ = r.cruiseQ;
+  if (exitN < 0) {
+    exitN = 0;
+    up    = (entryN < r.cruiseAccelN) ? r.cruiseAccelN - entryN : 0;
+    down  = r.cruiseDecelN;
+    if (up + down > steps) {
+      up = r.peakShare.mulInt(steps + entryN) - entryN;
+      up = constrain(up, 0L, steps);
+      down = steps - up;
+      if (entryN + up > 0) cruiseQ = rampSeedQ(r.accelRamp.t1Q, entryN + up);
+    }
+  }
+  seg.dir         = dir;
+  seg.accelSteps  = up;
+  seg.cruiseSteps = steps - up - down;
+  seg.decelSteps  = down;
+  seg.entryN      = entryN;
+  seg.exitN       = exitN;
+  seg.cruiseRPS   = r.cruiseRPS;
+  seg.cruiseQ     = cruiseQ;
+  seg.accelRamp   = r.accelRamp;
+  seg.decelRamp   = r.decelRamp;
+  seg.accelSeedQ  = (up > 0 && entryN > 0) ? rampSeedQ(r.accelRamp.t1Q, entryN + 1) : 0;
+  seg.decelSeedQ  = (down > 0) ? rampSeedQ(r.decelRamp.t1Q, exitN + down) : 0;
+}
+
+// ── State getters ─────────────────────────────────────────────────────────────
+
+long MotorBase::positionSteps() const {
+  long pos;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { pos = _position; }
+  return pos;
+}
+
+float MotorBase::speedRPS() const {
+  unsigned long period;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { period = _periodUs; }
+  return period ? 1000000.0f / ((float)period * _stepsPerRev) : 0.0f;
+}
+
+// ── Soft limits ───────────────────────────────────────────────────────────────
+
+void MotorBase::setSoftLimits(long minSteps, long maxSteps) {
+  if (maxSteps < minSteps) {
+    Serial.println("MotorBase::setSoftLimits: maxSteps below minSteps.");
+    return;
+  }
+  _softMin    = minSteps;
+  _softMax    = maxSteps;
+  _softLimits = true;
+}
+
+// A move starting outside the window is allowed back in; a monotonic move that ends inside
+// never leaves it on the way.
+bool MotorBase::softAllows(long steps, const char* fn) const {
+  if (!_softLimits) return true;
+  long target = positionSteps() + steps;
+  if (target >= _softMin && target <= _softMax) return true;
+  Serial.print(fn); Serial.print(": target "); Serial.print(target);
+  Serial.print(" outside soft limits "); Serial.print(_softMin);
+  Serial.print(".."); Serial.print(_softMax); Serial.println(" — move rejected.");
+  return false;
+}
+
+// ── Private helpers ───────────────────────────────────────────────────────────
+
+// The ISR fires on FALLING edge; if the switch is already held LOW, no edge fires.
+void MotorBase::seedLimitFlag(int8_t dir) {
+  if (!_hasLimits) return;
+  if (dir > 0) _limitEndFlag  = (_limitEndPin  >= 0 && digitalRead(_limitEndPin)  == LOW);
+  else         _limitHomeFlag = (_limitHomePin >= 0 && digitalRead(_limitHomePin) == LOW);
+}
+
+// a = maxRPS² / (2 · limitStopRevs), with the stop distance snapped to whole steps.
+Fixed MotorBase::limitDecelRate() const {
+  long maxStopSteps = Fixed::fromFloat(_limitStopRevs).mulInt(_stepsPerRev);
+  if (_maxRPS <= 0.0f || maxStopSteps <= 0) return Fixed();
+  Fixed maxRPS = Fixed::fromFloat(_maxRPS);
+  return maxRPS * maxRPS / (Fixed::ratio(maxStopSteps, _stepsPerRev) * 2);
+}
+
+// Fixed decel rate (see planMove): stops the motor from _maxRPS within _limitStopRevs.
+// Stop distance n = v² / (2a) = (T_1 / T)², taken as a Q8 period ratio; the first period
+// is then the exact T_1 / sqrt(n) so the recurrence lands on the n <= 3 values. All 32-bit:
+// one isqrt32 and three divides instead of the float sqrt block (~300 µs on AVR).
+// Runs inside the generator (possibly in the ISR) — the Serial report is deferred to reportMove().
+void MotorBase::beginLimitDecel() {
+  _limitHitPhase    = _phase;
+  _limitHitPeriodUs = _periodUs;
+  _rampTable        = nullptr;  // the limit ramp has its own rate
+  _limitSteps       = 0;
+  _phaseStep        = 0;
+  _phase            = PHASE_LIMIT;
+
+  if (_limitRamp.t1Q == 0) { _phase = PHASE_IDLE; return; }
+
+  _limitSteps = rampIndexAt(_limitRamp.t1Q, _periodUs);
+  if (_limitSteps < 1) { _phase = PHASE_IDLE; return; }
+  _limitSeedQ = rampSeedQ(_limitRamp.t1Q, _limitSteps);
+}
+
+void MotorBase::setLimitRate(Fixed accel) {
+  _limitRamp.accel = accel;
+  _limitRamp.t1Q   = (accel > Fixed()) ? rampPeriodQ(accel, _stepsPerRev, 1) : 0;
+}
+
+unsigned long MotorBase::rampPeriod(const RampRate& ramp, long n) {
+  float speed = sqrt(2.0f * ramp.accel.toFloat() * _stepsPerRev * n);
+  if (speed < 1.0f) speed = 1.0f;
+  return (unsigned long)(1000000.0f / speed);
+}
+
+// Austin/Eiderman recurrence on the speed-indexed period T_n = 1 / sqrt(2·a·n).
+// Matching T_{n+1}/T_n = sqrt(n/(n+1)) to second order gives
+//   accel:  T_n = T_{n-1} - 2·T_{n-1} / (4n - 1)
+//   decel:  T_n = T_{n+1} + 2·T_{n+1} / (4n + 1)
+// (the 4n+1 / 4n-5 form in notes/austin-recurrence-runtrap.md runs ~1/(4·n0) fast for a
+// seed at n0). With n <= RAMP_EXACT_STEPS evaluated exactly, the Q20.12 period stays within
+// ~0.2 % of sqrt() and the error shrinks as 1/n² afterwards; what reaches the driver is then
+// dominated by the 1 µs output rounding, same as the sqrt path.
+// A stride of s indices in one step (resonance bands) matches to the same order with
+//   accel:  T_n = T_{n-s} - 2s·T_{n-s} / (4n - s)
+//   decel:  T_n = T_{n+s} + 2s·T_{n+s} / (4n + s)
+// which is the single-step form at s = 1 — still one divide per step.
+unsigned long MotorBase::rampUp(const RampRate& ramp, long n, unsigned long seedQ, bool first,
+                                uint8_t stride) {
+  if (_rampTable)             return pgm_read_word(_rampTable + n - 1);
+  if (_rampMode == RAMP_SQRT) return rampPeriod(ramp, n);
+  if (n <= RAMP_EXACT_STEPS || first) {
+    _rampQ   = (n <= RAMP_EXACT_STEPS) ? exactPeriodQ(ramp.t1Q, n) : seedQ;
+    _rampRem = 0;
+  } else {
+    unsigned long delta = austinDelta(_rampQ, 4UL * n - stride, _rampRem);
+    _rampQ -= (stride > 1) ? delta * stride : delta;
+  }
+  if (_rampQ < _cruiseQ) _rampQ = _cruiseQ;
+  return qToUs(_rampQ);
+}
+
+unsigned long MotorBase::rampDown(const RampRate& ramp, long n, unsigned long seedQ, bool first,
+                                  uint8_t stride) {
+  if (_rampTable)             return pgm_read_word(_rampTable + n - 1);
+  if (_rampMode == RAMP_SQRT) return rampPeriod(ramp, n);
+  if (n <= RAMP_EXACT_STEPS || first) {
+    _rampQ   = (n <= RAMP_EXACT_STEPS) ? exactPeriodQ(ramp.t1Q, n) : seedQ;
+    _rampRem = 0;
+  } else {
+    unsigned long delta = austinDelta(_rampQ, 4UL * n + stride, _rampRem);
+    _rampQ += (stride > 1) ? delta * stride : delta;
+    if (_rampQ > RAMP_Q_MAX) _rampQ = RAMP_Q_MAX;
+  }
+  return qToUs(_rampQ);
+}
+
+// ── S-curve generator ─────────────────────────────────────────────────────────
+// Constant-jerk kinematics integrated in time, one step at a time:
+//   a' = a + j·T,   v' = v + T·(a + a')/2      (exact for constant jerk)
+// Units are binary-scaled per µs — v in steps/µs·2^32, a in steps/µs²·2^48, j in
+// steps/µs³·2^64 — so every update is a 32×32→64 multiply and a byte shift. Segment ends
+// snap a (and the top speed) to their planned values, so rounding never accumulates
+// across a move.
+
+void MotorBase::sCurveBegin(int8_t sign) {
+  _sSign     = sign;
+  _sSeg      = 0;
+  _sSegLeft  = _sJerkUs;
+  _sHalfLeft = 2 * _sJerkUs + _sConstUs;
+  _sAccel    = 0;
+  _sSpeed    = (sign > 0) ? 0 : _sSpeedTop;
+  _sRem      = 0;
+}
+
+void MotorBase::sCurveAdvance(unsigned long dt) {
+  while (dt > 0 && _sSeg < 3) {
+    unsigned long span = (dt < _sSegLeft) ? dt : _sSegLeft;
+    int32_t jerk = (_sSeg == 1) ? 0 : (_sSeg == 0) ? _sJerk : -_sJerk;
+    if (_sSign < 0) jerk = -jerk;
+
+    int32_t accel = _sAccel + (int32_t)(((int64_t)jerk * (int32_t)span) >> 16);
+    int32_t avg   = (_sAccel >> 1) + (accel >> 1);
+    int32_t dv    = (int32_t)(((int64_t)avg * (int32_t)span) >> 16);
+    _sSpeed = (dv < 0 && (uint32_t)(-dv) >= _sSpeed) ? 0 : _sSpeed + dv;
+    _sAccel = accel;
+
+    _sSegLeft  -= span;
+    _sHalfLeft -= span;
+    dt         -= span;
+    if (_sSegLeft == 0) {
+      _sSeg++;
+      if (_sSeg == 1) { _sAccel = _sSign * _sAccelMax; _sSegLeft = _sConstUs; }
+      if (_sSeg == 2) _sSegLeft = _sJerkUs;
+      if (_sSeg == 3) { _sAccel = 0; if (_sSign > 0) _sSpeed = _sSpeedTop; }
+    }
+  }
+  if (_sSpeed < _sSpeedMin) _sSpeed = _sSpeedMin;
+}
+
+// T0 = 1 / v, corrected to second order for the speed change within the step:
+// T = T0 · (1 - a·T0² / 2). Without the correction the accel half falls ~ln(n)/4 steps
+// short of the analytic distance. The remainder of 1 / v is carried between steps like
+// the Austin remainder, so whole-µs periods average to the exact ones and the emitted
+// steps stay on the integrated distance.
+unsigned long MotorBase::sCurvePeriod() {
+  if (_sSpeed < 4295UL) return 1000000UL;          // below 1 step/s
+  unsigned long t0 = 0xFFFFFFFFUL / _sSpeed;
+  _sRem += 0xFFFFFFFFUL % _sSpeed;
+  if (_sRem >= _sSpeed) { _sRem -= _sSpeed; t0++; }
+
+  const int64_t X_MAX  = 1L << 16;                // |a·T0²| <= 1 keeps T in [T0/2, 3T0/2]
+  const int64_t DV_MAX = 0x7FFFFFFFL;
+  int64_t dv = ((int64_t)_sAccel * (int32_t)t0) >> 16;          // a·T0, steps/µs·2^32
+  int64_t x;                                                     // a·T0², 2^-16
+  if      (dv >  DV_MAX) x =  X_MAX;
+  else if (dv < -DV_MAX) x = -X_MAX;
+  else                      x = ((int64_t)(int32_t)dv * (int32_t)t0) >> 16;
+  if (x >  X_MAX) x =  X_MAX;
+  if (x < -X_MAX) x = -X_MAX;
+  return t0 - (long)((((int64_t)(int32_t)x * (int32_t)t0) + (1L << 16)) >> 17);
+}
+
+// The first period is the analytic time to the first step from rest, t1 = cbrt(6 / j);
+// after that the accel half ends on time — the step that would overrun it goes to cruise.
+unsigned long MotorBase::sCurveUp() {
+  if (_phaseStep == 0) {
+    sCurveBegin(1);
+    sCurveAdvance(_sFirstUs);
+    return _sFirstUs;
+  }
+  if (_sHalfLeft == 0) return 0;
+  unsigned long period = sCurvePeriod();
+  if (period >= _sHalfLeft) return 0;
+  sCurveAdvance(period);
+  return period;
+}
+
+// Decel runs the accel half mirrored in time. The last step takes whatever time the half
+// has left, mirroring the first accel step from rest; if the time has run out, the
+// remaining steps hold the last period.
+unsigned long MotorBase::sCurveDown(bool first, bool last) {
+  if (first) sCurveBegin(-1);
+  else if (_sHalfLeft == 0) return _sPeriodUs;
+  unsigned long period = sCurvePeriod();
+  if (last && _sHalfLeft > period) period = _sHalfLeft;
+  sCurveAdvance(period);
+  _sPeriodUs = period;
+  return period;
+}
+
+// Ramp index n counts steps from standstill: accel runs n = 1..accelSteps,
+// decel and limit decel run n = steps..1, so both ends of the ramp are symmetric.
+unsigned long MotorBase::nextStepPeriod() {
+  if (_phase != PHASE_IDLE) {
+    bool lagging = (_tachPin >= 0) && tachStalled();   // accounts pulses in the stop as well
+    if (_phase != PHASE_LIMIT) {
+      if (lagging) _stalled = true;
+      if (_stalled || limitTriggered() || (_group && _group->limitTriggered())) beginLimitDecel();
+    }
+  }
+
+  for (;;) {
+    _genPhase = _phase;
+    switch (_phase) {
+      case PHASE_ACCEL:
+        if (_sCurve) {
+          unsigned long period = (_phaseStep < _accelSteps + _cruiseSteps) ? sCurveUp() : 0;
+          if (period) { _phaseStep++; return period; }
+          // The S-curve accel ends on time, not on a step count: settle the difference
+          // from the planned count against cruise.
+          _cruiseSteps += _accelSteps - _phaseStep;
+          _accelSteps   = _phaseStep;
+        } else if (_phaseStep + _bandSkip < _accelSteps) {
+          bool    first = (_phaseStep == 0);
+          uint8_t s     = (first || !_bandCount) ? 1 : bandStride(_accelSteps - _phaseStep - _bandSkip);
+          _bandSkip += s - 1;
+          long n     = _entryN + ++_phaseStep + _bandSkip;
+          _rampUs    = _curveRun ? curveUp(n, first, s) : rampUp(_accelRamp, n, _accelSeedQ, first, s);
+          return _rampUs;
+        }
+        // Band strides end the ramp early: the steps saved are cruised instead.
+        _cruiseSteps += _bandSkip;
+        _accelSteps  -= _bandSkip;
+        _phase        = PHASE_CRUISE;
+        _phaseStep    = 0;
+        _bandSkip     = 0;
+        break;
+
+      case PHASE_CRUISE:
+        if (_phaseStep < _cruiseSteps) {
+          if (!_jog) _phaseStep++;                      // a jog cruises until replanned
+          return _cruisePeriodUs;
+        }
+        _phase     = PHASE_DECEL;
+        _phaseStep = 0;
+        break;
+
+      case PHASE_DECEL:
+        if (_phaseStep < _decelSteps) {
+          bool first = (_phaseStep == 0);
+          if (_sCurve) { _phaseStep++; return sCurveDown(first, _phaseStep == _decelSteps); }
+          long    n = _decelSteps - _phaseStep++ - _bandSkip;   // ramp index above exitN
+          uint8_t s = (first || !_bandCount) ? 1 : bandStride(n - 1);
+          if (s == 1 && _bandSkip > 0) { _bandSkip--; return _rampUs; }   // repay a stride
+          _bandSkip += s - 1;
+          _rampUs    = _curveRun ? curveDown(n - s + 1, first, s)
+                                 : rampDown(_decelRamp, _exitN + n - s + 1, _decelSeedQ, first, s);
+          return _rampUs;
+        }
+        if (_queue && _queue->loadNext()) break;
+        if (_chainPending) { _chainPending = false; chainSegment(_chainSeg); break; }
+        _phase = PHASE_IDLE;
+        break;
+
+      case PHASE_LIMIT:
+        if (_phaseStep < _limitSteps) {
+          bool first = (_phaseStep == 0);
+          return rampDown(_limitRamp, _limitSteps - _phaseStep++, _limitSeedQ, first);
+        }
+        _phase = PHASE_IDLE;
+        break;
+
+      default:
+        return 0;
+    }
+  }
+}
+
+void MotorBase::planSegment(Segment& seg, long aSteps, long cSteps, long dSteps,
+                            Fixed cruiseRPS, Fixed accel, Fixed decel, int8_t dir,
+                            long entryN, long exitN) const {
+  seg.dir             = dir;
+  seg.accelSteps      = aSteps;
+  seg.cruiseSteps     = (cruiseRPS > Fixed()) ? cSteps : 0;
+  seg.decelSteps      = dSteps;
+  seg.entryN          = entryN;
+  seg.exitN           = exitN;
+  seg.cruiseRPS       = cruiseRPS;
+  seg.cruiseQ         = speedPeriodQ(cruiseRPS, _stepsPerRev);
+  seg.accelRamp.accel = accel;
+  seg.accelRamp.t1Q   = rampPeriodQ(accel, _stepsPerRev, 1);
+  seg.decelRamp.accel = decel;
+  seg.decelRamp.t1Q   = rampPeriodQ(decel, _stepsPerRev, 1);
+  seg.accelSeedQ      = (aSteps > 0 && entryN > 0) ? rampPeriodQ(accel, _stepsPerRev, entryN + 1) : 0;
+  seg.decelSeedQ      = (dSteps > 0) ? rampPeriodQ(decel, _stepsPerRev, exitN + dSteps) : 0;
+}
+
+void MotorBase::loadSegment(const Segment& seg) {
+  _dir            = seg.dir;
+  _accelSteps     = seg.accelSteps;
+  _cruiseSteps    = seg.cruiseSteps;
+  _decelSteps     = seg.decelSteps;
+  _entryN         = seg.entryN;
+  _exitN          = seg.exitN;
+  _cruiseRPS      = seg.cruiseRPS;
+  _cruiseQ        = seg.cruiseQ;
+  _cruisePeriodUs = qToUs(seg.cruiseQ);
+  _accelRamp      = seg.accelRamp;
+  _decelRamp      = seg.decelRamp;
+  _accelSeedQ     = seg.accelSeedQ;
+  _decelSeedQ     = seg.decelSeedQ;
+  _phaseStep      = 0;
+  _bandSkip       = 0;
+  _phase          = PHASE_ACCEL;
+}
+
+// Continue at seg when the current segment ends; a direction change re-seeds the limit flag.
+void MotorBase::chainSegment(const Segment& seg) {
+  if (seg.dir != _dir) {
+    setDirection(seg.dir > 0);
+    seedLimitFlag(seg.dir);
+  }
+  loadSegment(seg);
+}
+
+void MotorBase::planMove(long aSteps, long cSteps, long dSteps,
+                          Fixed cruiseRPS, Fixed accel, Fixed decel, int8_t dir) {
+  Segment seg;
+  planSegment(seg, aSteps, cSteps, dSteps, cruiseRPS, accel, decel, dir);
+  beginMove(seg);
+}
+
+void MotorBase::beginMove(const Segment& seg) {
+  // Pre-seed the flag for whichever limit we're moving toward.
+  seedLimitFlag(seg.dir);
+
+  loadSegment(seg);
+  setLimitRate(limitDecelRate());
+
+  _rampTable      = nullptr;
+  _sCurve         = false;
+  _curveRun       = nullptr;
+  _limitHitPhase  = PHASE_IDLE;
+  _limitSteps     = 0;
+  _stalled        = false;
+  _chainPending   = false;
+  _jog            = false;
+}
+
+void MotorBase::startRun(bool report) {
+  _reportPending = report;
+  _phaseMarked  = 0;
+  _periodUs     = 0;
+  _doneEvent    = false;
+  _moveStartPos = _position;
+  _moveTarget   = _position + _dir * (_accelSteps + _cruiseSteps + _decelSteps);
+  if (_jitter) _jitter->beginMove();
+  if (_tachPin >= 0) {
+    _tachSeen    = _tachPulses;
+    _tachPos     = _position;
+    _tachBalance = 0;
+    _tachTotal   = 0;
+  }
+
+  _nextPeriodUs = nextStepPeriod();
+  _nextPhase    = _genPhase;
+  if (_nextPeriodUs == 0) { finishMove(); return; }
+  _busy = true;
+
+  if (_timerSlot >= 0) {
+    _timerTicksLeft = 0;
+    StepTimer::start(_timerSlot);
+  } else {
+    _pollDueUs = micros();
+  }
+}
+
+void MotorBase::runMove() {
+  startRun();
+  waitDone();
+}
+
+unsigned long MotorBase::phaseStartUs(Phase p, unsigned long fallback) const {
+  return (_phaseMarked & (1 << p)) ? _phaseStartUs[p] : fallback;
+}
+
+void MotorBase::finishMove() {
+  _moveEndUs = micros();
+  _periodUs  = 0;
+  _phase     = PHASE_IDLE;
+  _doneEvent = true;
+  _busy      = false;
+}
+
+void MotorBase::reportMove() {
+  static const char* const PHASE_NAMES[] = {"", "accel", "cruise", "decel"};
+
+  if (_limitHitPhase != PHASE_IDLE) {
+    Serial.print(_stalled ? "Stall (tach) during " : "Limit hit during ");
+    Serial.print(PHASE_NAMES[_limitHitPhase]);
+    float hitRPS = _limitHitPeriodUs ? 1000000.0f / ((float)_limitHitPeriodUs * _stepsPerRev) : 0.0f;
+    Serial.print(" at "); Serial.print(hitRPS, 3); Serial.println(" RPS — decelling to stop.");
+    if (_limitSteps > 0) {
+      Serial.print(_stalled ? "Stall decel: " : "Limit decel: "); Serial.print(_limitSteps);
+      Serial.print(" steps ("); Serial.print((float)_limitSteps / _stepsPerRev, 3);
+      Serial.println(" revs)");
+    }
+  }
+
+  // ── Serial timing report ───────────────────────────────────────────────────
+  unsigned long decelEnd  = _moveEndUs;
+  unsigned long cruiseEnd = phaseStartUs(PHASE_DECEL,  decelEnd);
+  unsigned long accelEnd  = phaseStartUs(PHASE_CRUISE, cruiseEnd);
+  unsigned long startTime = phaseStartUs(PHASE_ACCEL,  accelEnd);
+
+  float tAccel  = (accelEnd  - startTime) / 1e6;
+  float tCruise = (cruiseEnd - accelEnd)  / 1e6;
+  float tDecel  = (decelEnd  - cruiseEnd) / 1e6;
+  float tTotal  = (decelEnd  - startTime) / 1e6;
+
+  float cruiseRPS  = _cruiseRPS.toFloat();
+  float tAccelExp  = (_accelSteps  > 0) ? cruiseRPS / _accelRamp.accel.toFloat() : 0;
+  float tCruiseExp = (_cruiseSteps > 0) ? (float)_cruiseSteps / (cruiseRPS * _stepsPerRev) : 0;
+  float tDecelExp  = (_decelSteps  > 0) ? cruiseRPS / _decelRamp.accel.toFloat() : 0;
+  float tTotalExp  = tAccelExp + tCruiseExp + tDecelExp;
+
+  float commandedRevs = (float)(_accelSteps + _cruiseSteps + _decelSteps) / _stepsPerRev;
+
+  Serial.print("--- Motor "); Serial.print(_id); Serial.println(" Move Complete ---");
+  Serial.print("Commanded: "); Serial.print(commandedRevs, 3); Serial.println(" rev");
+  Serial.print("Position: "); Serial.println(positionSteps());
+  if (_tachPin >= 0) {
+    Serial.print("Tach: "); Serial.print(tachRevs(), 3); Serial.print(" rev counted, ");
+    Serial.print((float)labs(positionSteps() - _moveStartPos) / _stepsPerRev, 3);
+    Serial.println(" rev stepped");
+  }
+
+  Serial.print("Accel:  Expected="); Serial.print(tAccelExp, 3);
+  Serial.print("s, Actual="); Serial.print(tAccel, 3); Serial.println("s");
+  Serial.print("Cruise: Expected="); Serial.print(tCruiseExp, 3);
+  Serial.print("s, Actual="); Serial.print(tCruise, 3); Serial.println("s");
+  Serial.print("Decel:  Expected="); Serial.print(tDecelExp, 3);
+  Serial.print("s, Actual="); Serial.print(tDecel, 3); Serial.println("s");
+
+  float err = tTotal - tTotalExp;
+  Serial.print("Total:  Expected="); Serial.print(tTotalExp, 3);
+  Serial.print("s, Actual="); Serial.print(tTotal, 3);
+  Serial.print("s, Error="); Serial.print(err, 3);
+  Serial.print("s (");
+  Serial.print(tTotalExp > 0 ? (err / tTotalExp) * 100.0 : 0, 2);
+  Serial.println("%)");
+}
+
+// Core 3-phase step executor: accel → cruise → decel.
+void MotorBase::startTrapezoid(long accelSteps, long cruiseSteps, long decelSteps,
+                                Fixed cruiseRPS, Fixed accel, Fixed decel, int8_t dir) {
+  planMove(accelSteps, cruiseSteps, decelSteps, cruiseRPS, accel, decel, dir);
+  startRun(true);
+}
+
+// ── Public move functions ─────────────────────────────────────────────────────
+
+void MotorBase::startManualTrapMove(float accelRevs, float cruiseRevs, float decelRevs,
+                                    float cruiseRPS) {
+  waitDone();
+  setDirection(accelRevs > 0);
+  int8_t dir = (accelRevs > 0) ? 1 : -1;
+  cruiseRPS  = snapCruise(cruiseRPS);
+
+  long aSteps = Fixed::fromFloat(accelRevs).abs().mulInt(_stepsPerRev);
+  long cSteps = Fixed::fromFloat(cruiseRevs).abs().mulInt(_stepsPerRev);
+  long dSteps = Fixed::fromFloat(decelRevs).abs().mulInt(_stepsPerRev);
+  if (!softAllows(dir * (aSteps + cSteps + dSteps), "MotorBase::manualTrapMove")) return;
+
+  // a = v² / (2 · ramp revs), on the step-snapped ramp length so the ramp lands on v exactly.
+  Fixed rps   = Fixed::fromFloat(cruiseRPS);
+  Fixed accel = (aSteps > 0) ? rps * rps / (Fixed::ratio(aSteps, _stepsPerRev) * 2) : Fixed();
+  Fixed decel = (dSteps > 0) ? rps * rps / (Fixed::ratio(dSteps, _stepsPerRev) * 2) : Fixed();
+
+  Serial.print("--- Motor "); Serial.print(_id); Serial.println(" Profile Move ---");
+  Serial.print("Accel="); Serial.print(accelRevs);
+  Serial.print(", Cruise="); Serial.print(cruiseRevs);
+  Serial.print(", Decel="); Serial.print(decelRevs);
+  Serial.print(" rev, RPS="); Serial.println(cruiseRPS);
+
+  startTrapezoid(aSteps, cSteps, dSteps, rps, accel, decel, dir);
+}
+
+void MotorBase::startAutoTrapMove(float revolutions, float maxRPS, float totalTime) {
+  waitDone();
+  long   totalSteps = Fixed::fromFloat(revolutions).abs().mulInt(_stepsPerRev);
+  int8_t dir = (revolutions > 0) ? 1 : -1;
+  if (!softAllows(dir * totalSteps, "MotorBase::autoTrapMove")) return;
+  setDirection(revolutions > 0);
+
+  Fixed revs     = Fixed::ratio(totalSteps, _stepsPerRev);
+  Fixed maxSpeed = Fixed::fromFloat(snapCruise(maxRPS));
+  Fixed time     = Fixed::fromFloat(totalTime);
+  Fixed tAccel   = (maxSpeed > Fixed()) ? time - revs / maxSpeed : Fixed();
+  Fixed tCruise  = time - tAccel * 2;
+
+  if (tAccel <= Fixed() || tCruise < Fixed()) {
+    Fixed peak      = revs * 2 / time;
+    Fixed tRamp     = time / 2;
+    Fixed a         = peak / tRamp;
+    long  halfSteps = totalSteps / 2;
+    startTrapezoid(halfSteps, 0, totalSteps - halfSteps, peak, a, a, dir);
+  } else {
+    Fixed a     = maxSpeed / tAccel;
+    long aSteps = (a * tAccel * tAccel / 2).mulInt(_stepsPerRev);
+    long cSteps = (maxSpeed * tCruise).mulInt(_stepsPerRev);
+    long dSteps = totalSteps - aSteps - cSteps;
+    startTrapezoid(aSteps, cSteps, dSteps, maxSpeed, a, a, dir);
+  }
+}
+
+void MotorBase::startTableTrapMove(const RampProfile& ramp, float revolutions) {
+  waitDone();
+  long   totalSteps = Fixed::fromFloat(revolutions).abs().mulInt(_stepsPerRev);
+  int8_t dir        = (revolutions > 0) ? 1 : -1;
+  long   rampSteps  = min((long)ramp.steps, totalSteps / 2);
+  if (!softAllows(dir * totalSteps, "MotorBase::tableTrapMove")) return;
+
+  // Rates are only used for the report; the step loop reads periods from flash.
+  Fixed rps  = Fixed::ratio(ramp.speed, _stepsPerRev);
+  Fixed rate = rps * rps / Fixed::ratio(2L * ramp.steps, _stepsPerRev);
+  if (rampSteps < (long)ramp.steps) rps = (rate * Fixed::ratio(2 * rampSteps, _stepsPerRev)).sqrt();
+  else if (totalSteps > 2 * rampSteps && safeSpeed(rps.toFloat()) != rps.toFloat())
+    Serial.println("MotorBase::tableTrapMove: the table's top speed is in a resonance band.");
+
+  Serial.print("--- Motor "); Serial.print(_id); Serial.println(" Table Move ---");
+  Serial.print("Ramp="); Serial.print(rampSteps);
+  Serial.print(" steps, Total="); Serial.print(totalSteps);
+  Serial.print(" steps, Peak="); Serial.print(rps.toFloat()); Serial.println(" RPS");
+
+  setDirection(revolutions > 0);
+  planMove(rampSteps, totalSteps - 2 * rampSteps, rampSteps, rps, rate, rate, dir);
+  _rampTable      = ramp.periods;
+  _cruisePeriodUs = (rampSteps == (long)ramp.steps)
+                    ? ramp.cruiseUs
+                    : pgm_read_word(ramp.periods + (rampSteps > 0 ? rampSteps - 1 : 0));
+  startRun(true);
+}
+
+void MotorBase::startSCurveMove(float revolutions, float maxRPS, float maxAccel, float maxJerk) {
+  waitDone();
+  long   totalSteps = Fixed::fromFloat(revolutions).abs().mulInt(_stepsPerRev);
+  int8_t dir        = (revolutions > 0) ? 1 : -1;
+
+  if (maxRPS == 0.0f || maxAccel == 0.0f || maxJerk == 0.0f) {
+    Serial.println("MotorBase::sCurveMove: maxRPS, maxAccel and maxJerk must be non-zero.");
+    return;
+  }
+  if (!softAllows(dir * totalSteps, "MotorBase::sCurveMove")) return;
+
+  maxRPS = snapCruise(maxRPS);
+
+  // Planned in float, in steps and seconds: jerk runs to 1e4–1e5 rev/s³ (past Q16.16) and
+  // the short-move case needs a cube root. Runs once per move; the generator gets integers.
+  float d = (float)totalSteps;
+  float v = fabs(maxRPS)   * _stepsPerRev;
+  float a = fabs(maxAccel) * _stepsPerRev;
+  float j = fabs(maxJerk)  * _stepsPerRev;
+  a = min(a, 7.6e6f);                                  // int32 range of _sAccelMax / _sJerk
+  j = min(j, 1.16e8f);
+  float tJ, tA;
+  if (v * j < a * a) { tJ = sqrt(v / j); a = j * tJ; tA = 0.0f; }   // maxAccel not reached
+  else               { tJ = a / j;       tA = v / a - tJ;        }
+  float rampSteps = v * (tA + 2.0f * tJ) / 2.0f;
+
+  // Too short for both halves: lower the peak speed, then the peak accel.
+  if (2.0f * rampSteps > d) {
+    tA = sqrt(d / a + tJ * tJ / 4.0f) - 1.5f * tJ;
+    if (tA < 0.0f) { tA = 0.0f; tJ = cbrt(d / (2.0f * j)); a = j * tJ; }
+    v         = a * (tA + tJ);
+    rampSteps = v * (tA + 2.0f * tJ) / 2.0f;
+  }
+
+  long  rSteps = min((long)(rampSteps + 0.5f), totalSteps / 2);
+  float t1     = cbrt(6.0f / j);                       // time to the first step from rest
+  float vMin   = min(j * t1 * t1 / 2.0f, v);
+
+  _sJerk     = (int32_t)(j * 18.446744f);                      // 2^64 / 1e18
+  _sAccelMax = (int32_t)(a * 281.47498f);                      // 2^48 / 1e12
+  _sSpeedTop = (uint32_t)(v    * 4294.9673f);                  // 2^32 / 1e6
+  _sSpeedMin = (uint32_t)(vMin * 4294.9673f);
+  _sJerkUs   = (unsigned long)(tJ * 1e6f + 0.5f);
+  _sConstUs  = (unsigned long)(tA * 1e6f + 0.5f);
+  _sFirstUs  = (unsigned long)(t1 * 1e6f + 0.5f);
+
+  Serial.print("--- Motor "); Serial.print(_id); Serial.println(" S-Curve Move ---");
+  Serial.print("Revs="); Serial.print(revolutions);
+  Serial.print(", Peak RPS="); Serial.print(v / _stepsPerRev);
+  Serial.print(", Peak Accel="); Serial.print(a / _stepsPerRev);
+  Serial.print(" rev/s², Jerk time="); Serial.print(tJ * 1000.0f, 1);
+  Serial.print(" ms, Const accel="); Serial.print(tA * 1000.0f, 1); Serial.println(" ms");
+
+  // Average accel over a half, so the report's expected ramp time is 2·tJ + tA.
+  Fixed rps = Fixed::fromFloat(v / _stepsPerRev);
+  Fixed avg = Fixed::fromFloat(v / (tA + 2.0f * tJ) / _stepsPerRev);
+
+  setDirection(revolutions > 0);
+  planMove(rSteps, totalSteps - 2 * rSteps, rSteps, rps, avg, avg, dir);
+  _sCurve = true;
+  startRun(true);
+}
+
+// Planned in ramp steps from rest on the curve's zones. The report expects the ramps at
+// their average rate, which gives the curve's ramp time.
+void MotorBase::startCurveMove(float revolutions, float maxRPS) {
+  waitDone();
+  if (!_torque || _torque->_zoneCount == 0) {
+    Serial.println("MotorBase::curveMove: no torque curve (setTorqueCurve after TorqueCurve::init).");
+    return;
+  }
+  if (maxRPS == 0.0f) {
+    Serial.println("MotorBase::curveMove: maxRPS must be non-zero.");
+    return;
+  }
+  long   totalSteps = Fixed::fromFloat(revolutions).abs().mulInt(_stepsPerRev);
+  int8_t dir        = (revolutions > 0) ? 1 : -1;
+  if (!softAllows(dir * totalSteps, "MotorBase::curveMove")) return;
+
+  Fixed rps       = Fixed::fromFloat(snapCruise(fabs(maxRPS)));
+  long  rampSteps = curveSteps(rps);
+  if (2 * rampSteps > totalSteps) {
+    rampSteps = totalSteps / 2;
+    rps       = curveSpeedAt(rampSteps);
+  }
+  float tRamp = curveTime(rps.toFloat());
+  Fixed avg   = (tRamp > 0.0f) ? Fixed::fromFloat(rps.toFloat() / tRamp) : Fixed();
+
+  Serial.print("--- Motor "); Serial.print(_id); Serial.println(" Curve Move ---");
+  Serial.print("Revs="); Serial.print(revolutions);
+  Serial.print(", Peak RPS="); Serial.print(rps.toFloat());
+  Serial.print(", Ramp="); Serial.print(rampSteps);
+  Serial.print(" steps in "); Serial.print(tRamp * 1000.0f, 1); Serial.println(" ms");
+
+  setDirection(revolutions > 0);
+  planMove(rampSteps, totalSteps - 2 * rampSteps, rampSteps, rps, avg, avg, dir);
+  _curveRun       = _torque;
+  _curveZone      = 0;
+  _curveRate.t1Q  = 0;                                  // loaded by the first curveIndex()
+  if (rampSteps > 0) {
+    const TorqueCurve::Zone& top = _torque->_zones[curveZoneOf(rampSteps)];
+    _decelSeedQ = rampPeriodQ(top.accel, _stepsPerRev, rampSteps - top.startStep + top.startN);
+  }
+  startRun(true);
+}
+
+void MotorBase::startSpinRevs(float revolutions, float rps) {
+  waitDone();
+  long   total = Fixed::fromFloat(revolutions).abs().mulInt(_stepsPerRev);
+  int8_t dir   = (revolutions > 0) ? 1 : -1;
+  if (!softAllows(dir * total, "MotorBase::spinRevs")) return;
+
+  setDirection(revolutions > 0);
+  planMove(0, total, 0, Fixed::fromFloat(snapCruise(rps)), Fixed(), Fixed(), dir);
+  startRun();
+}
+
+// ── Blocking moves: start, then wait for completion (report and done callback included) ──
+
+void MotorBase::manualTrapMove(float accelRevs, float cruiseRevs, float decelRevs,
+                                float cruiseRPS) {
+  startManualTrapMove(accelRevs, cruiseRevs, decelRevs, cruiseRPS);
+  waitDone();
+}
+
+void MotorBase::autoTrapMove(float revolutions, float maxRPS, float totalTime) {
+  startAutoTrapMove(revolutions, maxRPS, totalTime);
+  waitDone();
+}
+
+void MotorBase::tableTrapMove(const RampProfile& ramp, float revolutions) {
+  startTableTrapMove(ramp, revolutions);
+  waitDone();
+}
+
+void MotorBase::sCurveMove(float revolutions, float maxRPS, float maxAccel, float maxJerk) {
+  startSCurveMove(revolutions, maxRPS, maxAccel, maxJerk);
+  waitDone();
+}
+
+void MotorBase::curveMove(float revolutions, float maxRPS) {
+  startCurveMove(revolutions, maxRPS);
+  waitDone();
+}
+
+void MotorBase::spinRevs(float revolutions, float rps) {
+  startSpinRevs(revolutions, rps);
+  waitDone();
+}
@@ -0,0 +1,50 @@
+// step_motor_driver.cpp
+// StepMotorDriver: step/direction pin control for Applied Motion drivers.
+
+#include "lib/driver/stepper/step_motor_driver.h"
+
+StepMotorDriver::StepMotorDriver(int dirPin, int stepPin, int enablePin,
+                                  int stepsPerRev, bool invertDir)
+  : _dirPin(dirPin), _stepPin(stepPin), _enablePin(enablePin),
+    _dirOut(dirPin), _stepOut(stepPin),
+    _stepsPerRev(stepsPerRev), _invertDir(invertDir) {}
+
+void StepMotorDriver::init() {
+  pinMode(_dirPin,  OUTPUT);
+  pinMode(_stepPin, OUTPUT);
+  if (_enablePin >= 0) pinMode(_enablePin, OUTPUT);
+}
+
+void StepMotorDriver::step(unsigned long stepPeriodUs) {
+  _stepOut.high();
+  delayMicroseconds(stepPeriodUs / 2);
+  _stepOut.low();
+  delayMicroseconds(stepPeriodUs - stepPeriodUs / 2);
+}
+
+void StepMotorDriver::stepBurst(const unsigned long* periods, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    _stepOut.high();
+    delayMicroseconds(periods[i] / 2);
+    _stepOut.low();
+    delayMicroseconds(periods[i] - periods[i] / 2);
+  }
+}
+
+void StepMotorDriver::pulse() {
+  _stepOut.high();
+  delayMicroseconds(PULSE_US);
+  _stepOut.low();
+}
+
+void StepMotorDriver::setDirection(bool forward) {
+  _dirOut.write(!(forward ^ _invertDir));
+}
+
+void StepMotorDriver::enable() {
+  if (_enablePin >= 0) digitalWrite(_enablePin, HIGH);
+}
+
+void StepMotorDriver::disable() {
+  if (_enablePin >= 0) digitalWrite(_enablePin, LOW);
+}
@@ -0,0 +1,79 @@
+// step_jitter.h
+// Per-step timing probe for MotorBase moves.
+// Attached with MotorBase::setJitterProbe(), it timestamps every emitted step and compares
+// the interval since the previous step with the period the generator commanded for it.
+// Each phase keeps count, min / mean / max error and a log2 histogram of |error|, from which
+// report() estimates percentiles; the WORST_LOG largest errors are kept with their step
+// number. Nothing is printed during the move.
+//
+// Usage:
+//   StepJitter xJitter;
+//   xMotor.setJitterProbe(&xJitter);   // every following move is recorded
+//   xMotor.autoTrapMove(10, 5, 2);
+//   xJitter.report();                  // then reset() before the next measurement
+//
+// Timestamps are micros(): 4 µs resolution on a 16 MHz AVR, so errors under 4 µs are noise,
+// and the probe's own micros() call is part of what it measures. While a probe is attached
+// the blocking cruise steps one at a time instead of in bursts. With attachPulseTimer() the
+// edges are made by the timer; the probe then times the ISR, not the edge.
+
+#pragma once
+
+#include <Arduino.h>
+
+class StepJitter {
+public:
+  static const uint8_t PHASES    = 4;    // accel, cruise, decel, limit decel
+  static const uint8_t BINS      = 16;   // |error| µs: 0, 1, 2–3, 4–7, ..., ≥ 16384
+  static const uint8_t WORST_LOG = 8;
+
+  StepJitter() { reset(); }
+
+  // Clear all statistics and the worst-step log.
+  void reset();
+
+  // Called by MotorBase when a move starts: the first step has no interval before it.
+  void beginMove();
+
+  // Called by MotorBase as each step is emitted (possibly in the step timer ISR).
+  // phase: MotorBase generator phase of this step (1–4). periodUs: the interval commanded
+  // after it. nowUs: micros() at the step.
+  void record(uint8_t phase, unsigned long periodUs, unsigned long nowUs);
+
+  // Intervals measured in phase (1–4), and the largest |error| seen there (µs).
+  unsigned long steps(uint8_t phase) const;
+  unsigned long maxErrorUs(uint8_t phase) const;
+
+  // Per-phase table and worst-step log over Serial.
+  void report() const;
+
+private:
+  struct PhaseStats {
+    unsigned long count;
+    long          minErr, maxErr, sumErr;   // actual − commanded, µs
+    unsigned long bins[BINS];
+  };
+
+  struct Offender {
+    long          step;                     // step number within its move
+    unsigned long commandedUs, actualUs;
+    uint8_t       phase;
+
+    long          errUs() const { return (long)(actualUs - commandedUs); }
+  };
+
+  PhaseStats    _stats[PHASES];
+  Offender      _worst[WORST_LOG];          // sorted, largest |error| first
+  uint8_t       _worstCount;
+
+  long          _step;                      // steps recorded in the current move
+  unsigned long _lastUs, _lastPeriodUs;
+  uint8_t       _lastPhase;                 // 0 = no step yet in this move
+
+  static uint8_t binOf(unsigned long absErr);
+
+  // Upper bound (µs) of the bin holding the pct-th percentile of |error| in s.
+  static unsigned long percentile(const PhaseStats& s, uint8_t pct);
+
+  void logWorst(const Offender& o);
+};
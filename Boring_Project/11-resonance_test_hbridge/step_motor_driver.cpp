@@ -6,6 +6,7 @@
 StepMotorDriver::StepMotorDriver(int dirPin, int stepPin, int enablePin,
                                   int stepsPerRev, bool invertDir)
   : _dirPin(dirPin), _stepPin(stepPin), _enablePin(enablePin),
+    _dirOut(dirPin), _stepOut(stepPin),
     _stepsPerRev(stepsPerRev), _invertDir(invertDir) {}
 
 void StepMotorDriver::init() {
@@ -15,14 +16,29 @@ void StepMotorDriver::init() {
 }
 
 void StepMotorDriver::step(unsigned long stepPeriodUs) {
-  digitalWrite(_stepPin, HIGH);
-  delayMicroseconds(stepPeriodUs / 2);
-  digitalWrite(_stepPin, LOW);
+  _stepOut.high();
   delayMicroseconds(stepPeriodUs / 2);
+  _stepOut.low();
+  delayMicroseconds(stepPeriodUs - stepPeriodUs / 2);
+}
+
+void StepMotorDriver::stepBurst(const unsigned long* periods, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    _stepOut.high();
+    delayMicroseconds(periods[i] / 2);
+    _stepOut.low();
+    delayMicroseconds(periods[i] - periods[i] / 2);
+  }
+}
+
+void StepMotorDriver::pulse() {
+  _stepOut.high();
+  delayMicroseconds(PULSE_US);
+  _stepOut.low();
 }
 
 void StepMotorDriver::setDirection(bool forward) {
-  digitalWrite(_dirPin, (forward ^ _invertDir) ? LOW : HIGH);
+  _dirOut.write(!(forward ^ _invertDir));
 }
 
 void StepMotorDriver::enable() {
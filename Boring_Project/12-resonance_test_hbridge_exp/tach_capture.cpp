@@ -0,0 +1,237 @@
+// tach_capture.cpp
+// TachCapture: input-capture timer setup, 32-bit stamp extension and capture ISR stubs.
+
+#include <util/atomic.h>
+#include "lib/driver/timer/tach_capture.h"
+#include "lib/driver/timer/step_timer.h"
+
+// ── Capture units ─────────────────────────────────────────────────────────────
+// Each unit owns one 16-bit timer running free at clk/8. The overflow ISR extends the count
+// to 32 bits; a capture latched just after a wrap whose overflow ISR has not run yet (TOVn
+// still pending, ICRn in the low half) belongs to the next high word.
+
+namespace {
+
+  static const int UNIT_COUNT = 2;
+  static TachCapture* _units[UNIT_COUNT] = {nullptr, nullptr};
+
+#if defined(__AVR__) && defined(TCCR5A)
+
+  struct CaptureRegs {
+    uint8_t            pin;
+    int8_t             timerSlot;   // StepTimer slot of the same timer
+    volatile uint8_t*  tccrA;
+    volatile uint8_t*  tccrB;
+    volatile uint16_t* tcnt;
+    volatile uint16_t* icr;
+    volatile uint8_t*  timsk;
+    volatile uint8_t*  tifr;
+  };
+
+  // ICNCn, ICESn, CSn1, ICIEn, TOIEn, ICFn and TOVn sit at the same bit positions on every
+  // 16-bit timer.
+  static const CaptureRegs UNITS[UNIT_COUNT] = {
+    {49, 2, &TCCR4A, &TCCR4B, &TCNT4, &ICR4, &TIMSK4, &TIFR4},
+    {48, 3, &TCCR5A, &TCCR5B, &TCNT5, &ICR5, &TIMSK5, &TIFR5},
+  };
+
+  static volatile uint16_t _overflows[UNIT_COUNT];
+
+  inline unsigned long extend(int u, uint16_t count) {
+    uint16_t hi = _overflows[u];
+    if ((*UNITS[u].tifr & _BV(TOV1)) && count < 0x8000) hi++;
+    return ((unsigned long)hi << 16) | count;
+  }
+
+#elif !defined(__AVR__)
+
+  // Off-target: edges arrive through attachInterrupt() and are stamped with micros().
+  static uint8_t _simPin[UNIT_COUNT];
+
+  static void captureISR0() { if (_units[0]) _units[0]->onCapture(micros() * TachCapture::TICKS_PER_US); }
+  static void captureISR1() { if (_units[1]) _units[1]->onCapture(micros() * TachCapture::TICKS_PER_US); }
+
+  typedef void (*IsrFunc)();
+  static const IsrFunc captureISRs[UNIT_COUNT] = {captureISR0, captureISR1};
+
+#endif
+
+} // anonymous namespace
+
+#if defined(__AVR__) && defined(TCCR5A)
+ISR(TIMER4_OVF_vect)  { _overflows[0]++; }
+ISR(TIMER4_CAPT_vect) { if (_units[0]) _units[0]->onCapture(extend(0, ICR4)); }
+ISR(TIMER5_OVF_vect)  { _overflows[1]++; }
+ISR(TIMER5_CAPT_vect) { if (_units[1]) _units[1]->onCapture(extend(1, ICR5)); }
+#endif
+
+// ── Setup ─────────────────────────────────────────────────────────────────────
+
+bool TachCapture::begin(uint8_t icpPin, uint16_t pulsesPerRev) {
+  end();
+  if (pulsesPerRev == 0) {
+    Serial.println("TachCapture::begin: pulsesPerRev must be non-zero.");
+    return false;
+  }
+
+  int8_t unit = -1;
+#if defined(__AVR__) && defined(TCCR5A)
+  for (int u = 0; u < UNIT_COUNT; u++) {
+    if (UNITS[u].pin == icpPin) unit = u;
+  }
+  if (unit < 0) {
+    Serial.println("TachCapture::begin: no input capture on this pin (D48 or D49).");
+    return false;
+  }
+  if (_units[unit] != nullptr || !StepTimer::reserve(UNITS[unit].timerSlot)) {
+    Serial.println("TachCapture::begin: timer in use.");
+    return false;
+  }
+#elif !defined(__AVR__)
+  for (int u = 0; u < UNIT_COUNT && unit < 0; u++) {
+    if (_units[u] == nullptr) unit = u;
+  }
+  if (unit < 0 || digitalPinToInterrupt(icpPin) == NOT_AN_INTERRUPT) {
+    Serial.println("TachCapture::begin: no free capture unit for this pin.");
+    return false;
+  }
+#else
+  (void)icpPin;
+  Serial.println("TachCapture::begin: no input capture unit on this board.");
+  return false;
+#endif
+
+  _slot      = unit;
+  _ppr       = pulsesPerRev;
+  _period    = 0;
+  _avgQ4     = 0;
+  _pulses    = 0;
+  _winCount  = 0;
+  _stamped   = false;
+  _units[unit] = this;
+  pinMode(icpPin, INPUT_PULLUP);
+
+#if defined(__AVR__) && defined(TCCR5A)
+  const CaptureRegs& r = UNITS[unit];
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *r.tccrA = 0;
+    *r.tccrB = 0;                                    // normal mode, TOP = 0xFFFF
+    *r.tcnt  = 0;
+    _overflows[unit] = 0;
+    *r.tifr  = _BV(ICF1) | _BV(TOV1);
+    *r.timsk = _BV(ICIE1) | _BV(TOIE1);
+    *r.tccrB = _BV(ICNC1) | _BV(CS11);               // noise canceler, falling edge, clk/8
+  }
+#elif !defined(__AVR__)
+  _simPin[unit] = icpPin;
+  attachInterrupt(digitalPinToInterrupt(icpPin), captureISRs[unit], FALLING);
+#endif
+  return true;
+}
+
+void TachCapture::end() {
+  if (_slot < 0 || _slot >= UNIT_COUNT || _units[_slot] != this) { _slot = -1; return; }
+#if defined(__AVR__) && defined(TCCR5A)
+  const CaptureRegs& r = UNITS[_slot];
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *r.tccrB = 0;
+    *r.timsk = 0;
+  }
+  StepTimer::release(r.timerSlot);
+#elif !defined(__AVR__)
+  detachInterrupt(digitalPinToInterrupt(_simPin[_slot]));
+#endif
+  _units[_slot] = nullptr;
+  _slot = -1;
+}
+
+// ── Capture ISR ───────────────────────────────────────────────────────────────
+// A period longer than STOP_US is the first edge after a stop: it restarts the average and
+// the ripple window instead of entering them.
+
+void TachCapture::onCapture(unsigned long stamp) {
+  unsigned long period = stamp - _lastStamp;
+  _lastStamp = stamp;
+  _pulses++;
+  if (!_stamped) { _stamped = true; return; }
+
+  if (period > STOP_US * TICKS_PER_US) {
+    _period   = 0;
+    _avgQ4    = 0;
+    _winCount = 0;
+    return;
+  }
+  _period = period;
+  if (_avgQ4 == 0) _avgQ4 = period << 4;
+  else             _avgQ4 += ((long)(period << 4) - (long)_avgQ4) >> FILTER_SHIFT;
+
+  if (_winCount == 0) {
+    _winStart = stamp - period;
+    _winMin   = period;
+    _winMax   = period;
+  } else {
+    if (period < _winMin) _winMin = period;
+    if (period > _winMax) _winMax = period;
+  }
+  _winCount++;
+}
+
+// ── Readings ──────────────────────────────────────────────────────────────────
+
+unsigned long TachCapture::nowTicks() const {
+#if defined(__AVR__) && defined(TCCR5A)
+  unsigned long now;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { now = extend(_slot, *UNITS[_slot].tcnt); }
+  return now;
+#elif !defined(__AVR__)
+  return micros() * TICKS_PER_US;
+#else
+  return 0;
+#endif
+}
+
+float TachCapture::toRPS(float periodTicks, unsigned long lastStamp) const {
+  if (periodTicks <= 0.0f || _slot < 0) return 0.0f;
+  unsigned long since = nowTicks() - lastStamp;
+  if (since > STOP_US * TICKS_PER_US) return 0.0f;
+  if (since > periodTicks) periodTicks = since;      // slowing: the next edge is at least this late
+  return (TICKS_PER_US * 1e6f) / (periodTicks * _ppr);
+}
+
+float TachCapture::rps() const {
+  unsigned long period, last;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { period = _period; last = _lastStamp; }
+  return toRPS(period, last);
+}
+
+float TachCapture::filteredRPS() const {
+  unsigned long avg, last;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { avg = _avgQ4; last = _lastStamp; }
+  return toRPS(avg / 16.0f, last);
+}
+
+void TachCapture::resetRipple() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { _winCount = 0; }
+}
+
+float TachCapture::ripplePct() const {
+  unsigned long count, span, lo, hi;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    count = _winCount;  span = _lastStamp - _winStart;  lo = _winMin;  hi = _winMax;
+  }
+  if (count < 2 || span == 0) return 0.0f;
+  return 100.0f * (hi - lo) * count / span;
+}
+
+float TachCapture::windowRPS() const {
+  unsigned long count, span;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { count = _winCount;  span = _lastStamp - _winStart; }
+  if (count == 0 || span == 0 || _ppr == 0) return 0.0f;
+  return (TICKS_PER_US * 1e6f) * count / ((float)span * _ppr);
+}
+
+unsigned long TachCapture::pulses() const {
+  unsigned long n;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { n = _pulses; }
+  return n;
+}
@@ -0,0 +1,140 @@
+// fast_pin.h
+// Direct port-register output for pins written on every step (step, direction, H-bridge
+// phases). digitalWrite() maps the pin through three PROGMEM tables, checks for a PWM timer
+// and saves SREG on every call — a few µs per write on a 16 MHz Mega, paid inside the step
+// period and inside the step timer ISR.
+//
+// FastPin resolves the output register and bit mask once, in its constructor; each write is
+// then a masked read-modify-write with interrupts held off for three instructions, so an
+// ISR writing another pin on the same port cannot be lost.
+//
+// FastPinT<PIN> resolves the pin at compile time from the ATmega2560 pin map. On ports A–G
+// a write is a single sbi/cbi instruction (atomic by itself); ports H–L are outside the
+// sbi/cbi range and take the same guarded read-modify-write as FastPin.
+//
+// Neither touches PWM: do not use them on a pin that analogWrite() drives.
+// Off-target (and on other boards for FastPinT) both fall back to digitalWrite().
+//
+// Usage:
+//   FastPin step(53);             // runtime pin, e.g. from a driver constructor
+//   step.high(); step.low();
+//   FastPinT<53>::high();         // compile-time pin
+
+#pragma once
+
+#include <Arduino.h>
+
+class FastPin {
+public:
+  explicit FastPin(uint8_t pin) : _pin(pin) {
+#if defined(__AVR__)
+    uint8_t port = digitalPinToPort(pin);
+    _out  = (port == NOT_A_PIN) ? sink() : portOutputRegister(port);
+    _mask = (port == NOT_A_PIN) ? 0 : digitalPinToBitMask(pin);
+#endif
+  }
+
+  uint8_t pin() const { return _pin; }
+
+#if defined(__AVR__)
+  void high() {
+    uint8_t sreg = SREG;
+    cli();
+    *_out |= _mask;
+    SREG = sreg;
+  }
+
+  void low() {
+    uint8_t sreg = SREG;
+    cli();
+    *_out &= ~_mask;
+    SREG = sreg;
+  }
+#else
+  void high() { digitalWrite(_pin, HIGH); }
+  void low()  { digitalWrite(_pin, LOW); }
+#endif
+
+  void write(bool level) { if (level) high(); else low(); }
+
+private:
+  uint8_t _pin;
+#if defined(__AVR__)
+  volatile uint8_t* _out;
+  uint8_t           _mask;
+
+  // Write target for pins without a port (NOT_A_PIN).
+  static volatile uint8_t* sink() { static uint8_t byte; return &byte; }
+#endif
+};
+
+// ── Compile-time pins ─────────────────────────────────────────────────────────
+
+namespace FastPinMap {
+  // ATmega2560 (Arduino Mega) digital pins 0–69: port letter and bit, as in the core's
+  // pins_arduino.h tables.
+  static const uint8_t PIN_COUNT = 70;
+
+  constexpr char portOf(uint8_t pin) {
+    return "EEEEGEHHHHBBBBJJHHDDDDAAAAAAAACCCCCCCCDGGGLLLLLLLLBBBBFFFFFFFFKKKKKKKK"[pin];
+  }
+
+  constexpr uint8_t bitOf(uint8_t pin) {
+    return "0145533456456710103210012345677654321072107654321032100123456701234567"[pin] - '0';
+  }
+}
+
+template <uint8_t PIN>
+class FastPinT {
+public:
+  static void output() { pinMode(PIN, OUTPUT); }
+
+#if defined(__AVR_ATmega2560__)
+  static void high() {
+    if (SBI_RANGE) { reg() |= MASK; return; }
+    uint8_t sreg = SREG;
+    cli();
+    reg() |= MASK;
+    SREG = sreg;
+  }
+
+  static void low() {
+    if (SBI_RANGE) { reg() &= (uint8_t)~MASK; return; }
+    uint8_t sreg = SREG;
+    cli();
+    reg() &= (uint8_t)~MASK;
+    SREG = sreg;
+  }
+#else
+  static void high() { digitalWrite(PIN, HIGH); }
+  static void low()  { digitalWrite(PIN, LOW); }
+#endif
+
+  static void write(bool level) { if (level) high(); else low(); }
+
+#if defined(__AVR_ATmega2560__)
+private:
+  static_assert(PIN < FastPinMap::PIN_COUNT, "FastPinT: the Mega has digital pins 0-69");
+
+  static const char    PORT      = FastPinMap::portOf(PIN);
+  static const uint8_t MASK      = 1 << FastPinMap::bitOf(PIN);
+  static const bool    SBI_RANGE = (PORT <= 'G');
+
+  // Folds to the one register for a constant PORT.
+  static volatile uint8_t& reg() {
+    switch (PORT) {
+      case 'A': return PORTA;
+      case 'B': return PORTB;
+      case 'C': return PORTC;
+      case 'D': return PORTD;
+      case 'E': return PORTE;
+      case 'F': return PORTF;
+      case 'G': return PORTG;
+      case 'H': return PORTH;
+      case 'J': return PORTJ;
+      case 'K': return PORTK;
+      default:  return PORTL;
+    }
+  }
+#endif
+};
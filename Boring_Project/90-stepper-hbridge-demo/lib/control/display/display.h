@@ -7,6 +7,7 @@
 
 class MotorBase;
 class LinearMotor;
+class TachCapture;
 
 namespace Display {
 
@@ -20,4 +21,9 @@ namespace Display {
   // Row 1: limit switch status — OK / HOME LIMIT / END LIMIT / BOTH.
   void renderMotorInfo(LinearMotor& m);
 
+  // Write tach readings to the LCD (rate-limited to 10 Hz).
+  // Row 0: filtered speed in RPS.
+  // Row 1: velocity ripple (%) over the tach's current ripple window.
+  void renderTachInfo(const TachCapture& t);
+
 } // namespace Display
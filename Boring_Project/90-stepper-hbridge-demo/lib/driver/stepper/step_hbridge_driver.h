@@ -3,10 +3,12 @@
 // Uses 4 phase pins (IN1–IN4) for full-step or half-step phase control.
 // Two PWM-capable enable pins (ENA, ENB) allow current limiting via duty cycle.
 // Extends StepperDriver directly — no step/dir pin; phase is tracked internally.
+// Phase pins are written through FastPin (direct port registers); ENA/ENB keep analogWrite.
 
 #pragma once
 
 #include "../stepper_driver.h"
+#include "../gpio/fast_pin.h"
 
 class StepHBridgeDriver : public StepperDriver {
 public:
@@ -28,10 +30,16 @@ public:
   // then hold for stepPeriodUs microseconds.
   void step(unsigned long stepPeriodUs) override;
 
+  // step() for each period, in one call.
+  void stepBurst(const unsigned long* periods, uint8_t count) override;
+
   // Advance one phase step immediately, with no delay.
   // Use in non-blocking loops where the caller manages timing via micros().
   void advance();
 
+  // StepperDriver hook for the step timer ISR — same as advance().
+  void pulse() override { advance(); }
+
   // Set the direction of phase advance. forward=true increments the phase index.
   void setDirection(bool forward) override;
 
@@ -46,10 +54,14 @@ public:
 
 protected:
   int     _in1, _in2, _in3, _in4;
+  FastPin _in1Out, _in2Out, _in3Out, _in4Out;   // port/mask resolved once, written every step
   int     _enaPin, _enbPin;
   int     _spr;
   uint8_t _dutyCycle;
   bool    _halfStep;
   bool    _forward;
   uint8_t _phase;   // current index into the active step table
+
+  // Write the current phase row to IN1–IN4.
+  void writePhase();
 };
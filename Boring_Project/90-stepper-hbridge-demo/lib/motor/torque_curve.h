@@ -0,0 +1,62 @@
+// torque_curve.h
+// Speed → acceleration limit of one axis, followed by MotorBase::curveMove().
+// A stepper's pull-out torque falls with speed, so the fastest ramp that keeps step
+// accelerates hard at low speed and gently near the top, where a single-rate trapezoid
+// has to run at the lowest rate everywhere. The curve is a table of (rev/s, rev/s²) points,
+// e.g. LinearMotor::findAccelLimit() at a few cruise speeds, less a margin.
+//
+// Between two points the ramp holds the lower of their accels; below the first point it
+// holds the first, above the last the last — it never asks for more than the table allows.
+// MotorBase::setTorqueCurve() turns the points into these constant-accel zones in the
+// axis' steps, so the generator runs the same integer recurrence as a plain trapezoid and
+// only swaps ramp constants at a zone edge. Add points where the curve bends.
+//
+// Usage:
+//   const TorqueCurve::Point X_TORQUE[] = {{2, 400}, {6, 250}, {10, 120}, {14, 60}};  // rps, accel
+//   TorqueCurve xTorque;
+//   xTorque.init(X_TORQUE, 4);          // points, count
+//   xMotor.setTorqueCurve(&xTorque);    // one curve per axis: the zones are in its steps
+//   xMotor.curveMove(20, 14);           // revolutions, maxRPS
+
+#pragma once
+
+#include <Arduino.h>
+#include "../util/fixed.h"
+
+class TorqueCurve {
+  friend class MotorBase;   // builds and walks the zones
+
+public:
+  struct Point {
+    float rps;     // rev/s
+    float accel;   // rev/s² the axis holds at that speed
+  };
+  static const uint8_t MAX_POINTS = 8;
+
+  TorqueCurve() : _pointCount(0), _zoneCount(0) {}
+
+  // Copy the table: 1 to MAX_POINTS points, rps from 0 up and strictly rising, every
+  // accel above 0. Returns false and keeps the old table otherwise.
+  bool init(const Point* points, uint8_t count);
+
+  // Accel (rev/s²) the curve allows at rps: interpolated between points, flat outside.
+  float accelAt(float rps) const;
+
+  uint8_t pointCount() const { return _pointCount; }
+
+private:
+  // One constant-accel stretch of the ramp from rest. Step counts and ramp indices are in
+  // the steps of the axis that built it.
+  struct Zone {
+    float         loRPS;       // speed at the zone's lower edge
+    Fixed         accel;       // rev/s²
+    unsigned long t1Q;         // index-1 period of the zone's ramp, Q20.12 µs
+    long          startStep;   // ramp steps from rest to loRPS
+    long          startN;      // ramp index of loRPS at the zone's accel
+  };
+
+  Point   _points[MAX_POINTS];
+  uint8_t _pointCount;
+  Zone    _zones[MAX_POINTS + 1];
+  uint8_t _zoneCount;
+};
@@ -6,10 +6,13 @@
 #include "lib/driver/stepper/str3.h"
 #include "lib/motor/linear_motor.h"
 #include "lib/motor/rotational_motor.h"
+#include "lib/motor/motion_group.h"
+#include "lib/motor/ramp_table.h"
 #include "lib/driver/lcd/lcd.h"
 #include "lib/control/display/display.h"
 
 const int BUTTON_PIN = 22;
+const int X_CALIB_ADDR = 0;   // EEPROM record of the X axis (see LinearMotor::saveCalibration)
 
 LiquidCrystal lcd(7, 8, 4, 5, 6, 11);  // RS, EN, D4, D5, D6, D7
 
@@ -19,12 +22,35 @@ STR3 zDriver(24, 25, 3200);  // dirPin, stepPin, stepsPerRev
 LinearMotor     xMotor;   // X-axis linear stage
 RotationalMotor zMotor;   // Z-axis rotational stage
 
+MotorBase* const XZ_AXES[] = {&xMotor, &zMotor};
+MotionGroup xzGroup;      // coordinated X+Z moves on one step clock
+
+// Flash ramp tables for the repeated production moves — no per-step math, same pulse train every run.
+// X: autoTrapMove(10, 5, 2) at 200 spr plans a triangle: 1000 steps up to 2000 steps/s.
+// Z: manualTrapMove(2, 10, 2, 10) at 3200 spr: 6400-step ramps to 32000 steps/s.
+typedef RampTable<1000, 2000>  X_RAMP;   // rampSteps, topSpeed (steps/s)
+typedef RampTable<6400, 32000> Z_RAMP;   // rampSteps, topSpeed (steps/s)
+
+// X resonance bands (rev/s) from the frequency sweeps — fill in from 01-resonance_test.
+const MotorBase::SpeedBand X_BANDS[] = {{3.0f, 4.0f}};   // loRPS, hiRPS
+
+// X torque curve (rev/s, rev/s²) — fill in from 02-stall_test's accel limits, less a margin.
+const TorqueCurve::Point X_TORQUE[] = {{2, 400}, {6, 250}, {10, 120}, {14, 60}};   // rps, accel
+TorqueCurve xTorque;
+
 void setup() {
   Serial.begin(115200);
   pinMode(BUTTON_PIN, INPUT_PULLUP);
 
   xMotor.init(1, &xDriver, 2, 3, 6.0f, 15.0f);  // id, driver, limitEndPin, limitHomePin, mmPerRev, maxRPS
   zMotor.init(2, &zDriver);                       // id, driver
+  //zMotor.attachPulseTimer();                    // hardware step edges — STEP must move to a timer output, e.g. D46
+  //xMotor.attachTach(18, 100, 0.25f);            // tachPin, pulsesPerRev, maxLagRevs — stop on a stall
+  //xMotor.setResonanceBands(X_BANDS, 1);          // bands, count — never cruise in one, ramp through at 4x
+  xTorque.init(X_TORQUE, 4);                       // points, count
+  xMotor.setTorqueCurve(&xTorque);                 // curve for xMotor.curveMove()
+  xMotor.setHomingSpeed(10, 40);                   // fastRPS, accel — approach, then latch at slowRPS
+  xzGroup.init(XZ_AXES, 2);                       // axes, count
 
   xMotor.enableLimits();
   while (digitalRead(BUTTON_PIN) == HIGH)  { delay(10); Display::renderMotorInfo(xMotor); }
@@ -37,7 +63,10 @@ void setup() {
   LCD::print("X-Axis");
   LCD::setCursor(0, 1);
   LCD::print("Calibrating...");
-  xMotor.calibrate(1.5);   // slowRPS
+  xMotor.bootCalibrate(X_CALIB_ADDR, 1.5);   // eepromAddr, slowRPS — full calibrate only without a record
+  xMotor.enableSoftLimits(0.25);             // marginRevs — planned moves and jogs stop short of the end switch
+  //xMotor.calibrate(1.5);                       // slowRPS — force a full recalibration, then
+  //xMotor.saveCalibration(X_CALIB_ADDR);        // eepromAddr
   xMotor.goHome(20);       // cruiseRPS
 
   //xMotor.goHome(10);
@@ -53,20 +82,20 @@ void loop() {
   delay(50);
 
   // ── Motor 1 (X-axis) ──────────────────────────────────────────────────
-  xMotor.autoTrapMove(10, 5, 2);                  // revolutions, maxRPS, totalTime
+  xMotor.tableTrapMove(X_RAMP::profile(),  10);   // ramp, revolutions  (= autoTrapMove(10, 5, 2))
   delay(500);
-  zMotor.manualTrapMove( 2,  10,  2, 10);         // accelRevs, cruiseRevs, decelRevs, cruiseRPS
-  zMotor.manualTrapMove(-2, -10, -2, 10);         // accelRevs, cruiseRevs, decelRevs, cruiseRPS
+  zMotor.tableTrapMove(Z_RAMP::profile(),  14);   // ramp, revolutions  (= manualTrapMove(2, 10, 2, 10))
+  zMotor.tableTrapMove(Z_RAMP::profile(), -14);   // ramp, revolutions
   delay(500);
-  xMotor.autoTrapMove(10, 5, 2);                  // revolutions, maxRPS, totalTime
+  xMotor.tableTrapMove(X_RAMP::profile(),  10);   // ramp, revolutions  (= autoTrapMove(10, 5, 2))
   delay(500);
-  zMotor.manualTrapMove( 2,  10,  2, 10);         // accelRevs, cruiseRevs, decelRevs, cruiseRPS
-  zMotor.manualTrapMove(-2, -10, -2, 10);         // accelRevs, cruiseRevs, decelRevs, cruiseRPS
+  zMotor.tableTrapMove(Z_RAMP::profile(),  14);   // ramp, revolutions  (= manualTrapMove(2, 10, 2, 10))
+  zMotor.tableTrapMove(Z_RAMP::profile(), -14);   // ramp, revolutions
   delay(500);
-  xMotor.autoTrapMove(10, 5, 2);                  // revolutions, maxRPS, totalTime
+  xMotor.tableTrapMove(X_RAMP::profile(),  10);   // ramp, revolutions  (= autoTrapMove(10, 5, 2))
   delay(500);
-  zMotor.manualTrapMove( 2,  10,  2, 10);         // accelRevs, cruiseRevs, decelRevs, cruiseRPS
-  zMotor.manualTrapMove(-2, -10, -2, 10);         // accelRevs, cruiseRevs, decelRevs, cruiseRPS
+  zMotor.tableTrapMove(Z_RAMP::profile(),  14);   // ramp, revolutions  (= manualTrapMove(2, 10, 2, 10))
+  zMotor.tableTrapMove(Z_RAMP::profile(), -14);   // ramp, revolutions
   delay(500);
 
   xMotor.goHome(15);                              // cruiseRPS
@@ -74,4 +103,21 @@ void loop() {
   // ── Motor 2 (Z-axis) ──────────────────────────────────────────────────
 
   //zMotor.autoTrapMove(10, 5, 10);               // revolutions, maxRPS, totalTime
+
+  // ── Torque curve — hard accel where the motor has torque, gentle near top speed ──
+  //xMotor.curveMove(10, 14);                      // revolutions, maxRPS
+
+  // ── Coordinated X+Z — both axes start and finish together ─────────────
+  //const float XZ_MOVE[] = {10, 14};              // revolutions per axis (X, Z)
+  //xzGroup.moveLinear(XZ_MOVE, 10, 50);           // revs per axis, feedRPS, accel
+
+  // ── Non-blocking — LCD stays live while the move runs ─────────────────
+  //xMotor.startAutoTrapMove(10, 5, 2);            // revolutions, maxRPS, totalTime
+  //while (xMotor.poll()) Display::renderMotorInfo(xMotor);
+
+  // ── Jog — ramped velocity mode, stops itself on a limit switch ────────
+  //xMotor.setTargetVelocity(12, 40);              // rps (sign = direction), accel
+  //while (digitalRead(BUTTON_PIN) == HIGH) { xMotor.poll(); Display::renderMotorInfo(xMotor); }
+  //xMotor.setTargetVelocity(0, 40);               // ramp down to rest
+  //xMotor.waitDone();
 }
@@ -0,0 +1,103 @@
+// Arduino.h
+// Host (Linux) stand-in for the Arduino core, for building lib/ and src/ off-target.
+// Covers the API the motion library uses: pins, time, external interrupts, Serial and
+// PROGMEM. Time is virtual and pins are simulated — see sim.h. Not a general Arduino port.
+// Matches the Mega where behaviour differs: int-sized delayMicroseconds() argument wraps at
+// 16 bits, and only D2/D3/D18–D21 have external interrupts.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <type_traits>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define NOT_A_PIN         0
+#define NOT_AN_INTERRUPT  -1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PI 3.1415926535897932384626433832795
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+// ── Pins ──
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int  digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+// ── Time (virtual) ──
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// ── External interrupts ──
+int  digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interruptNum);
+void noInterrupts();
+void interrupts();
+
+// ── PROGMEM: flash is ordinary memory on the host ──
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s)    (s)
+inline uint8_t  pgm_read_byte(const void* p)  { return *(const uint8_t*)p; }
+inline uint16_t pgm_read_word(const void* p)  { return *(const uint16_t*)p; }
+inline uint32_t pgm_read_dword(const void* p) { return *(const uint32_t*)p; }
+
+// ── Math helpers (macros in the AVR core) ──
+template <class A, class B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return (a < b) ? a : b; }
+template <class A, class B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return (a > b) ? a : b; }
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define sq(x) ((x) * (x))
+
+char* dtostrf(double val, signed char width, unsigned char prec, char* buf);
+
+// ── Serial: output goes to the simulator's capture buffer ──
+class HardwareSerial {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int  available() { return 0; }
+  int  read()      { return -1; }
+  void flush()     {}
+
+  size_t print(const char* s);
+  size_t print(char c);
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = DEC)           { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC)  { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+
+  size_t println() { return print("\r\n"); }
+  template <class T>
+  size_t println(T v) { size_t n = print(v); return n + println(); }
+  template <class T>
+  size_t println(T v, int format) { size_t n = print(v, format); return n + println(); }
+};
+
+extern HardwareSerial Serial;
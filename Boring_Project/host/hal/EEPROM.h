@@ -0,0 +1,18 @@
+// EEPROM.h
+// Host stand-in for the Arduino EEPROM library: the Mega's 4 KB, erased (0xFF) at start.
+// Contents survive Sim::reset() like a power cycle; Sim::eraseEeprom() wipes them and
+// Sim::eepromWrites() counts the bytes actually written (update() skips equal bytes).
+
+#pragma once
+
+#include "Arduino.h"
+
+class EEPROMClass {
+public:
+  uint8_t  read(int addr);
+  void     write(int addr, uint8_t value);
+  void     update(int addr, uint8_t value);
+  uint16_t length();
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,17 @@
+// LiquidCrystal.h
+// Host stand-in for the Arduino LiquidCrystal library: a 16x2 character buffer, read back
+// through Sim::lcdLine().
+
+#pragma once
+
+#include "Arduino.h"
+
+class LiquidCrystal {
+public:
+  LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7);
+
+  void begin(uint8_t cols, uint8_t rows);
+  void clear();
+  void setCursor(uint8_t col, uint8_t row);
+  size_t print(const char* text);
+};
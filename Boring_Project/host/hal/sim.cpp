@@ -0,0 +1,360 @@
+// sim.cpp
+// Host Arduino stand-in: virtual clock, simulated pins and interrupts, Serial and LCD capture.
+
+#include "Arduino.h"
+#include "LiquidCrystal.h"
+#include "EEPROM.h"
+#include "sim.h"
+
+HardwareSerial Serial;
+
+namespace {
+
+  static const int PIN_COUNT = 70;         // Mega D0–D69
+  static const int INT_COUNT = 6;          // INT0–INT5
+
+  struct TimedInput   { unsigned long atUs; uint8_t pin, level; };
+  struct SteppedInput { uint8_t stepPin; long stepsLeft; uint8_t pin, level; };
+  struct Trace        { uint8_t stepPin, dirPin; std::vector<Sim::Step> steps; };
+
+  static unsigned long _now;
+  static uint8_t       _level[PIN_COUNT];
+  static bool          _driven[PIN_COUNT];  // input held by a script, not by pinMode
+  static bool          _interruptsOn;
+
+  static void (*_isr[INT_COUNT])();
+  static int           _isrMode[INT_COUNT];
+  static bool          _isrPending[INT_COUNT];
+
+  static std::vector<TimedInput>   _timed;      // sorted by atUs
+  static std::vector<SteppedInput> _stepped;
+  static std::vector<Trace>        _traces;
+  static std::vector<Sim::Write>   _writes;
+  static bool                      _recordWrites;
+  static Sim::WriteHook            _hook;
+
+  static std::string _serial;
+  static bool        _echo;
+
+  static char    _lcd[2][17];
+  static uint8_t _lcdCol, _lcdRow;
+
+  static const std::vector<Sim::Step> NO_STEPS;
+
+  // Mega external interrupt pins: D2 INT0 ... D18 INT5 (attachInterrupt numbering).
+  static int interruptOf(uint8_t pin) {
+    switch (pin) {
+      case 2:  return 0;
+      case 3:  return 1;
+      case 21: return 2;
+      case 20: return 3;
+      case 19: return 4;
+      case 18: return 5;
+      default: return NOT_AN_INTERRUPT;
+    }
+  }
+
+  static void runIsr(int n) {
+    _isrPending[n] = false;
+    if (!_isr[n]) return;
+    bool on = _interruptsOn;
+    _interruptsOn = false;                   // AVR: I-bit cleared inside an ISR
+    _isr[n]();
+    _interruptsOn = on;
+  }
+
+  static void setLevel(uint8_t pin, uint8_t level) {
+    if (pin >= PIN_COUNT) return;
+    uint8_t old = _level[pin];
+    _level[pin] = level ? HIGH : LOW;
+    if (old == _level[pin]) return;
+
+    int n = interruptOf(pin);
+    if (n < 0 || !_isr[n]) return;
+    bool edge = (_isrMode[n] == CHANGE) ||
+                (_isrMode[n] == RISING  && _level[pin] == HIGH) ||
+                (_isrMode[n] == FALLING && _level[pin] == LOW);
+    if (!edge) return;
+    if (_interruptsOn) runIsr(n);
+    else               _isrPending[n] = true;
+  }
+
+  static void onRisingEdge(uint8_t pin) {
+    for (size_t i = 0; i < _traces.size(); i++) {
+      Trace& t = _traces[i];
+      if (t.stepPin != pin) continue;
+      Sim::Step s = {_now, (t.dirPin < PIN_COUNT) ? _level[t.dirPin] : (uint8_t)0};
+      t.steps.push_back(s);
+    }
+    for (size_t i = 0; i < _stepped.size();) {
+      SteppedInput& s = _stepped[i];
+      if (s.stepPin == pin && --s.stepsLeft <= 0) {
+        uint8_t in = s.pin, level = s.level;
+        _stepped.erase(_stepped.begin() + i);
+        Sim::setInput(in, level);
+      } else {
+        i++;
+      }
+    }
+  }
+
+  // Move the clock to target, applying timed inputs on the way.
+  static void advanceTo(unsigned long target) {
+    while (!_timed.empty() && (long)(_timed.front().atUs - target) <= 0) {
+      TimedInput e = _timed.front();
+      _timed.erase(_timed.begin());
+      if ((long)(e.atUs - _now) > 0) _now = e.atUs;
+      Sim::setInput(e.pin, e.level);
+    }
+    if ((long)(target - _now) > 0) _now = target;
+  }
+
+  static const int EEPROM_SIZE = 4096;
+  static uint8_t       _eeprom[EEPROM_SIZE];
+  static unsigned long _eepromWrites = 0;
+  struct EepromInit { EepromInit() { memset(_eeprom, 0xFF, sizeof(_eeprom)); } } _eepromInit;
+
+  static void lcdClear() {
+    for (int r = 0; r < 2; r++) {
+      memset(_lcd[r], ' ', 16);
+      _lcd[r][16] = '\0';
+    }
+    _lcdCol = _lcdRow = 0;
+  }
+
+  struct AutoReset { AutoReset() { Sim::reset(); } } _autoReset;
+
+} // anonymous namespace
+
+// ── Arduino core ──────────────────────────────────────────────────────────────
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= PIN_COUNT || _driven[pin]) return;
+  if (mode == INPUT_PULLUP) setLevel(pin, HIGH);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  if (pin >= PIN_COUNT) return;
+  level = level ? HIGH : LOW;
+  bool rising = (level == HIGH && _level[pin] == LOW);
+  setLevel(pin, level);
+  if (_recordWrites) {
+    Sim::Write w = {_now, pin, level};
+    _writes.push_back(w);
+  }
+  if (rising) onRisingEdge(pin);
+  if (_hook) _hook(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+  return (pin < PIN_COUNT) ? _level[pin] : LOW;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  digitalWrite(pin, value > 127 ? HIGH : LOW);
+}
+
+unsigned long micros() { return _now; }
+unsigned long millis() { return _now / 1000; }
+
+void delay(unsigned long ms) { advanceTo(_now + ms * 1000); }
+
+void delayMicroseconds(unsigned int us) { advanceTo(_now + (uint16_t)us); }
+
+int digitalPinToInterrupt(uint8_t pin) { return interruptOf(pin); }
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode) {
+  if (interruptNum >= INT_COUNT) return;
+  _isr[interruptNum]        = isr;
+  _isrMode[interruptNum]    = mode;
+  _isrPending[interruptNum] = false;
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  if (interruptNum >= INT_COUNT) return;
+  _isr[interruptNum]        = nullptr;
+  _isrPending[interruptNum] = false;
+}
+
+void noInterrupts() { Sim::setInterrupts(false); }
+void interrupts()   { Sim::setInterrupts(true); }
+
+char* dtostrf(double val, signed char width, unsigned char prec, char* buf) {
+  sprintf(buf, "%*.*f", width, prec, val);
+  return buf;
+}
+
+// ── Serial ────────────────────────────────────────────────────────────────────
+
+size_t HardwareSerial::print(const char* s) {
+  _serial += s;
+  if (_echo) fputs(s, stdout);
+  return strlen(s);
+}
+
+size_t HardwareSerial::print(char c) {
+  char s[2] = {c, '\0'};
+  return print(s);
+}
+
+size_t HardwareSerial::print(long n, int base) {
+  if (base == DEC) {
+    char s[24];
+    snprintf(s, sizeof(s), "%ld", n);
+    return print(s);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t HardwareSerial::print(unsigned long n, int base) {
+  char s[40];
+  char* p = s + sizeof(s) - 1;
+  *p = '\0';
+  if (base < 2) base = DEC;
+  do { *--p = "0123456789ABCDEF"[n % base]; n /= base; } while (n);
+  return print(p);
+}
+
+size_t HardwareSerial::print(double n, int digits) {
+  char s[48];
+  snprintf(s, sizeof(s), "%.*f", digits, n);
+  return print(s);
+}
+
+// ── LiquidCrystal ─────────────────────────────────────────────────────────────
+
+LiquidCrystal::LiquidCrystal(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) {}
+
+void LiquidCrystal::begin(uint8_t, uint8_t) { lcdClear(); }
+void LiquidCrystal::clear()                 { lcdClear(); }
+
+void LiquidCrystal::setCursor(uint8_t col, uint8_t row) {
+  _lcdCol = col;
+  _lcdRow = (row < 2) ? row : 1;
+}
+
+size_t LiquidCrystal::print(const char* text) {
+  size_t n = 0;
+  for (; text[n]; n++) {
+    if (_lcdCol < 16) _lcd[_lcdRow][_lcdCol] = text[n];
+    _lcdCol++;
+  }
+  return n;
+}
+
+// ── EEPROM ────────────────────────────────────────────────────────────────────
+
+EEPROMClass EEPROM;
+
+uint8_t EEPROMClass::read(int addr) {
+  return (addr >= 0 && addr < EEPROM_SIZE) ? _eeprom[addr] : 0xFF;
+}
+
+void EEPROMClass::write(int addr, uint8_t value) {
+  if (addr < 0 || addr >= EEPROM_SIZE) return;
+  _eeprom[addr] = value;
+  _eepromWrites++;
+}
+
+void EEPROMClass::update(int addr, uint8_t value) {
+  if (read(addr) != value) write(addr, value);
+}
+
+uint16_t EEPROMClass::length() { return EEPROM_SIZE; }
+
+// ── Simulator control ─────────────────────────────────────────────────────────
+
+namespace Sim {
+
+void reset() {
+  _now = 0;
+  for (int i = 0; i < PIN_COUNT; i++) { _level[i] = LOW; _driven[i] = false; }
+  for (int i = 0; i < INT_COUNT; i++) { _isr[i] = nullptr; _isrPending[i] = false; }
+  _interruptsOn = true;
+  _timed.clear();
+  _stepped.clear();
+  _traces.clear();
+  _writes.clear();
+  _recordWrites = true;
+  _hook         = nullptr;
+  _serial.clear();
+  _echo         = false;
+  lcdClear();
+}
+
+unsigned long nowUs()              { return _now; }
+void          advanceUs(unsigned long us) { advanceTo(_now + us); }
+
+void setInput(uint8_t pin, uint8_t level) {
+  if (pin >= PIN_COUNT) return;
+  _driven[pin] = true;
+  setLevel(pin, level);
+}
+
+void setInputAt(uint8_t pin, uint8_t level, unsigned long atUs) {
+  TimedInput e = {atUs, pin, level};
+  size_t i = 0;
+  while (i < _timed.size() && (long)(_timed[i].atUs - atUs) <= 0) i++;
+  _timed.insert(_timed.begin() + i, e);
+}
+
+void setInputAfterSteps(uint8_t pin, uint8_t level, uint8_t stepPin, long steps) {
+  SteppedInput s = {stepPin, steps, pin, level};
+  _stepped.push_back(s);
+}
+
+uint8_t pinLevel(uint8_t pin) { return (pin < PIN_COUNT) ? _level[pin] : LOW; }
+
+const std::vector<Write>& writes() { return _writes; }
+void recordWrites(bool on)         { _recordWrites = on; }
+
+void traceSteps(uint8_t stepPin, uint8_t dirPin) {
+  Trace t;
+  t.stepPin = stepPin;
+  t.dirPin  = dirPin;
+  _traces.push_back(t);
+}
+
+const std::vector<Step>& steps(uint8_t stepPin) {
+  for (size_t i = 0; i < _traces.size(); i++) {
+    if (_traces[i].stepPin == stepPin) return _traces[i].steps;
+  }
+  return NO_STEPS;
+}
+
+void clearSteps() {
+  for (size_t i = 0; i < _traces.size(); i++) _traces[i].steps.clear();
+}
+
+bool writeStepCsv(uint8_t stepPin, const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) return false;
+  const std::vector<Step>& s = steps(stepPin);
+  fprintf(f, "step,us,dir\n");
+  for (size_t i = 0; i < s.size(); i++) fprintf(f, "%zu,%lu,%u\n", i, s[i].us, s[i].dir);
+  fclose(f);
+  return true;
+}
+
+void setWriteHook(WriteHook hook) { _hook = hook; }
+
+const std::string& serialOutput() { return _serial; }
+void clearSerial()                { _serial.clear(); }
+void echoSerial(bool on)          { _echo = on; }
+
+const char* lcdLine(uint8_t row) { return _lcd[row < 2 ? row : 1]; }
+
+void          eraseEeprom()  { memset(_eeprom, 0xFF, sizeof(_eeprom)); _eepromWrites = 0; }
+unsigned long eepromWrites() { return _eepromWrites; }
+
+bool interruptsEnabled() { return _interruptsOn; }
+
+void setInterrupts(bool on) {
+  _interruptsOn = on;
+  if (!on) return;
+  for (int n = 0; n < INT_COUNT; n++) {
+    if (_isrPending[n]) runIsr(n);
+  }
+}
+
+} // namespace Sim
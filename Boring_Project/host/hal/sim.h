@@ -0,0 +1,87 @@
+// sim.h
+// Control and inspection of the host-side Arduino stand-in (Arduino.h in this directory).
+// The HAL runs on a virtual clock: micros() only moves when the code waits — delay(),
+// delayMicroseconds(), or StepTimer::service() waiting for the next simulated compare match —
+// so a move that takes seconds on the Mega runs in milliseconds and is exactly repeatable.
+//
+// What the simulator offers:
+//   - digitalWrite traffic, recorded with timestamps, and per-pin step traces (rising edges
+//     on a STEP pin with the DIR level), exportable as CSV.
+//   - Scriptable digitalRead inputs: set now, at a virtual time, or after a number of steps.
+//   - An ISR dispatcher for attachInterrupt(): edges on an input call the attached handler,
+//     or are held while interrupts are off (noInterrupts / ATOMIC_BLOCK) and run after.
+//   - Serial output captured to a buffer (optionally echoed), and a 16x2 LiquidCrystal.
+//   - A 4 KB EEPROM (EEPROM.h) that keeps its contents across reset().
+//
+// Usage:
+//   Sim::reset();
+//   Sim::traceSteps(53, 51);                 // stepPin, dirPin
+//   Sim::setInputAfterSteps(2, LOW, 53, 1500); // end limit closes after 1500 steps
+//   ...run moves...
+//   Sim::writeStepCsv(53, "steps.csv");
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Sim {
+
+  struct Write {
+    unsigned long us;
+    uint8_t       pin, level;
+  };
+
+  struct Step {
+    unsigned long us;
+    uint8_t       dir;       // DIR pin level at the edge
+  };
+
+  // Clock to 0, outputs LOW, inputs HIGH (idle pull-up), handlers detached, traces, scripts,
+  // Serial and LCD cleared, interrupts on. The EEPROM is kept.
+  void reset();
+
+  // ── Clock ──
+  unsigned long nowUs();
+  void advanceUs(unsigned long us);          // same as delayMicroseconds, without the 16-bit cap
+
+  // ── Inputs ──
+  // Drive an input pin as the outside world would. An edge runs the attached ISR.
+  void setInput(uint8_t pin, uint8_t level);
+  // At virtual time atUs (applied while the clock advances past it).
+  void setInputAt(uint8_t pin, uint8_t level, unsigned long atUs);
+  // After steps more rising edges on stepPin (e.g. a limit switch at a travel distance).
+  void setInputAfterSteps(uint8_t pin, uint8_t level, uint8_t stepPin, long steps);
+
+  // ── Outputs ──
+  uint8_t pinLevel(uint8_t pin);
+  const std::vector<Write>& writes();
+  void recordWrites(bool on);                // default on
+
+  // Record rising edges on stepPin, with dirPin's level (dirPin 0xFF = none).
+  void traceSteps(uint8_t stepPin, uint8_t dirPin);
+  const std::vector<Step>& steps(uint8_t stepPin);
+  void clearSteps();
+  // CSV "step,us,dir" of the trace on stepPin; false when the file cannot be written.
+  bool writeStepCsv(uint8_t stepPin, const char* path);
+
+  // Called after every digitalWrite — for plant models in simulation programs.
+  typedef void (*WriteHook)(uint8_t pin, uint8_t level);
+  void setWriteHook(WriteHook hook);
+
+  // ── Serial and LCD ──
+  const std::string& serialOutput();
+  void clearSerial();
+  void echoSerial(bool on);                  // copy Serial to stdout; default off
+  const char* lcdLine(uint8_t row);          // current text of an LCD row (16 chars)
+
+  // ── EEPROM ──
+  void          eraseEeprom();               // every byte to 0xFF, write count to 0
+  unsigned long eepromWrites();              // bytes written since the last erase
+
+  // ── Interrupt state (used by Arduino.h and util/atomic.h) ──
+  bool interruptsEnabled();
+  void setInterrupts(bool on);
+
+} // namespace Sim
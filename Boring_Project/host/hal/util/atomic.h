@@ -0,0 +1,18 @@
+// util/atomic.h
+// Host stand-in for avr-libc's ATOMIC_BLOCK: simulated interrupts are held for the block
+// and restored (running any held ISR) when it ends.
+
+#pragma once
+
+#include "../sim.h"
+
+#define ATOMIC_RESTORESTATE 1
+#define ATOMIC_FORCEON      1
+
+namespace Sim {
+  inline bool atomicEnter() { bool on = interruptsEnabled(); setInterrupts(false); return on; }
+}
+
+#define ATOMIC_BLOCK(type) \
+  for (bool _simRestore = Sim::atomicEnter(), _simOnce = true; _simOnce; \
+       Sim::setInterrupts(_simRestore), _simOnce = false)
@@ -0,0 +1,521 @@
+// motion_sim.cpp
+// Host simulation of the motion library on the simulated HAL (hal/sim.h).
+// Runs the same trapezoid through the blocking loop, the step timer ISR and hardware pulse
+// mode and compares every emitted step with the analytic trapezoid; then calibrates a
+// LinearMotor against a simulated stage with limit switches, trips its end limit mid-move and
+// jams the stage under a tach-monitored move; saves the calibration to the simulated EEPROM
+// and boots from it. Also reads a jog's speed and ripple back through
+// TachCapture, reruns the trapezoid across a resonance band, times a torque-curve move
+// against the single-rate trapezoid it replaces, and bisects the accel at which a stage
+// that slips under hard acceleration starts losing steps.
+// Every result is checked against a tolerance; any miss prints FAIL and the exit code is 1.
+//
+// Usage (from host/):
+//   make test                         # build, run, fail on any check
+//   make && ./motion_sim              # summary
+//   ./motion_sim -v                   # also echo the library's Serial output
+//   ./motion_sim -csv steps.csv       # export the blocking move's step trace
+
+#include <math.h>
+#include "sim.h"
+#include "lib/driver/stepper/str3.h"
+#include "lib/motor/rotational_motor.h"
+#include "lib/motor/linear_motor.h"
+#include "lib/driver/timer/tach_capture.h"
+#include "lib/control/display/display.h"
+#include "lib/driver/lcd/lcd.h"
+#include "EEPROM.h"
+
+// ── CONFIGURATION ──────────────────────────────────────────────────────────────
+const int   STEPS_PER_REV = 800;
+const float ACCEL_REVS    = 2;
+const float CRUISE_REVS   = 6;
+const float DECEL_REVS    = 2;
+const float CRUISE_RPS    = 10;
+
+const uint8_t ROT_DIR = 30, ROT_STEP = 31;        // RotationalMotor, ISR / blocking pulses
+const uint8_t HW_DIR  = 47, HW_STEP  = 46;        // RotationalMotor on OC5A, hardware pulses
+const uint8_t LIN_DIR = 51, LIN_STEP = 53;        // LinearMotor (99-main-program X axis)
+const uint8_t END_PIN = 2,  HOME_PIN = 3;
+
+const long STAGE_HOME = -1500;                    // simulated stage: sensor positions (steps)
+const long STAGE_END  = 4200;
+const int  CALIB_ADDR = 0;                        // EEPROM address of the stage's calibration
+const uint8_t  TACH_PIN = 18;                     // driver Tach Out, simulated from the steps
+const uint16_t TACH_PPR = 100;
+const long     JAM_AT   = 1000;                   // stage jams this many steps into the move
+const uint8_t  ROT_TACH = 19;                     // RotationalMotor tach, for TachCapture
+const float    JOG_RPS  = 5;
+const float    BAND_LO  = 4, BAND_HI = 6;         // resonance band (rev/s) on the rotational motor
+const float    SLIP_ACCEL = 120;                  // stage loses forward steps above this (rev/s²)
+const float    CURVE_REVS = 8,  CURVE_RPS = 14;   // torque-curve move on the rotational motor
+const TorqueCurve::Point TORQUE[] = {{2, 400}, {6, 250}, {10, 120}, {14, 60}};   // rps, accel
+// Trapezoid vs the speed-indexed profile: the Austin recurrence runs a ramp up to +0.22 %
+// long (notes/austin-recurrence-runtrap.md) — +641 µs on this 400 ms accel, all of it in the
+// first ramp steps; cruise periods are whole µs here (125 µs) and the decel is seeded exactly.
+const double   TRAP_TIME_TOL = 0.001;             // move time, fraction of the analytic
+const double   TRAP_DEV_US   = 900;               // worst step time, 0.22 % of the 400 ms ramp
+// ──────────────────────────────────────────────────────────────────────────────
+
+// ── Checks: every miss prints FAIL and makes main() return 1 ──
+
+static int checks = 0, failures = 0;
+
+static void check(bool ok, const char* what) {
+  checks++;
+  if (ok) return;
+  failures++;
+  printf("FAIL: %s\n", what);
+}
+
+static bool near(double x, double want, double tol) { return fabs(x - want) <= tol; }
+
+// Analytic period (µs) of step k (0-based) of a trapezoid of aSteps/cSteps/dSteps at v
+// steps/s, in the library's speed-indexed convention: ramp step k runs for T_{k+1}, with
+// T_n = 1 / sqrt(2·α·n) from rest (step 1 lands at T_1, where the position-indexed
+// t = sqrt(2n/α) would put it at 2·T_1), cruise steps for 1/v, and the decel replays
+// T_dSteps … T_1.
+static double analyticPeriodUs(long k, long aSteps, long cSteps, long dSteps, double v) {
+  double alpha = v * v / (2.0 * aSteps);          // steps/s²
+  double delta = v * v / (2.0 * dSteps);
+  double t;
+  if (k < aSteps)               t = 1.0 / sqrt(2.0 * alpha * (k + 1));
+  else if (k < aSteps + cSteps) t = 1.0 / v;
+  else                          t = 1.0 / sqrt(2.0 * delta * (aSteps + cSteps + dSteps - k));
+  return t * 1e6;
+}
+
+// Compare the trace on stepPin with the analytic profile; returns the trace.
+static const std::vector<Sim::Step>& compare(const char* label, uint8_t stepPin, unsigned long endUs) {
+  const std::vector<Sim::Step>& s = Sim::steps(stepPin);
+  long   a = (long)(ACCEL_REVS * STEPS_PER_REV), c = (long)(CRUISE_REVS * STEPS_PER_REV);
+  long   d = (long)(DECEL_REVS * STEPS_PER_REV);
+  double v = CRUISE_RPS * STEPS_PER_REV;
+  double maxDev = 0, sumSq = 0;
+  long   worst = 0;
+  double t = 0;                                    // analytic time of step i, µs
+  for (size_t i = 0; i < s.size(); i++) {
+    double dev = (double)(s[i].us - s[0].us) - t;
+    sumSq += dev * dev;
+    if (fabs(dev) > fabs(maxDev)) { maxDev = dev; worst = i; }
+    t += analyticPeriodUs(i, a, c, d, v);
+  }
+  double total = 0;
+  for (long k = 0; k < a + c + d; k++) total += analyticPeriodUs(k, a, c, d, v);
+  total /= 1e6;
+  double sec   = s.empty() ? 0.0 : (endUs - s[0].us) / 1e6;
+  double rms   = s.empty() ? 0.0 : sqrt(sumSq / s.size());
+  printf("%-22s steps=%zu (planned %ld)  time=%.4fs (analytic %.4fs)  "
+         "dev max=%+.0fus @%ld rms=%.1fus\n",
+         label, s.size(), a + c + d, sec, total, maxDev, worst, rms);
+  check((long)s.size() == a + c + d, "trapezoid: step count");
+  check(near(sec, total, TRAP_TIME_TOL * total), "trapezoid: move time vs analytic");
+  check(fabs(maxDev) <= TRAP_DEV_US, "trapezoid: worst step-time deviation vs analytic");
+  return s;
+}
+
+static double maxDiffUs(const std::vector<Sim::Step>& x, const std::vector<Sim::Step>& y) {
+  double m = 0;
+  for (size_t i = 0; i < x.size() && i < y.size(); i++) {
+    double d = fabs((double)(x[i].us - x[0].us) - (double)(y[i].us - y[0].us));
+    if (d > m) m = d;
+  }
+  return m;
+}
+
+// ── Simulated linear stage: position from STEP/DIR, sensors from position ──
+
+static long stagePos = 0;
+
+static void stageHook(uint8_t pin, uint8_t level) {
+  if (pin != LIN_STEP || level != HIGH) return;
+  stagePos += (Sim::pinLevel(LIN_DIR) == LOW) ? 1 : -1;   // STR3: DIR LOW = forward
+  Sim::setInput(HOME_PIN, stagePos <= STAGE_HOME ? LOW : HIGH);
+  Sim::setInput(END_PIN,  stagePos >= STAGE_END  ? LOW : HIGH);
+}
+
+// ── Slipping stage: forward steps are lost while the accel over the last 4 steps exceeds
+// SLIP_ACCEL, as a motor pulling a load out of its torque does ──
+
+static unsigned long slipUs[5];
+static int           slipSeen = 0;
+
+static void slipHook(uint8_t pin, uint8_t level) {
+  if (pin != LIN_STEP || level != HIGH) return;
+  for (int i = 4; i > 0; i--) slipUs[i] = slipUs[i - 1];
+  slipUs[0] = Sim::nowUs();
+  if (slipSeen < 5) slipSeen++;
+  bool forward = (Sim::pinLevel(LIN_DIR) == LOW);
+  if (forward && slipSeen == 5) {
+    double v0 = 1e6 / (double)(slipUs[0] - slipUs[1]), v4 = 1e6 / (double)(slipUs[3] - slipUs[4]);
+    double dt    = ((double)(slipUs[0] - slipUs[3]) + (double)(slipUs[1] - slipUs[4])) / 2e6;
+    double accel = (v0 - v4) / dt / 200.0;                 // rev/s², between interval midpoints
+    if (fabs(accel) > SLIP_ACCEL) return;
+  }
+  stageHook(pin, level);
+}
+
+// ── Simulated tach: one pulse every stepsPerRev / TACH_PPR steps until the stage jams ──
+
+static long tachSteps = 0;
+
+static void tachHook(uint8_t pin, uint8_t level) {
+  if (pin != LIN_STEP || level != HIGH) return;
+  if (++tachSteps < JAM_AT && tachSteps % (200 / TACH_PPR) == 0) {
+    Sim::setInput(TACH_PIN, LOW);
+    Sim::setInput(TACH_PIN, HIGH);
+  }
+}
+
+// ── Jamming stage with tach: forward steps stop moving it JAM_AT steps after arming, until
+// the first step back ──
+
+static bool jamArmed  = false;
+static long jamSteps  = 0, jamTach = 0;
+
+static void jamStageHook(uint8_t pin, uint8_t level) {
+  if (pin != LIN_STEP || level != HIGH) return;
+  if (Sim::pinLevel(LIN_DIR) != LOW) jamArmed = false;
+  else if (jamArmed && ++jamSteps >= JAM_AT) return;
+  stageHook(pin, level);
+  if (++jamTach % (200 / TACH_PPR) == 0) {
+    Sim::setInput(TACH_PIN, LOW);
+    Sim::setInput(TACH_PIN, HIGH);
+  }
+}
+
+// ── Stage that drops every 50th backward step: steps lost without reaching a switch ──
+
+static long dropCount = 0;
+
+static void dropHook(uint8_t pin, uint8_t level) {
+  if (pin != LIN_STEP || level != HIGH) return;
+  if (Sim::pinLevel(LIN_DIR) != LOW && ++dropCount % 50 == 0) return;
+  stageHook(pin, level);
+}
+
+// Steps of a trace whose period puts the speed inside (lo, hi) rev/s; their total time in *us.
+static long bandSteps(const std::vector<Sim::Step>& s, float lo, float hi, double* us) {
+  long n = 0;
+  *us = 0;
+  for (size_t i = 1; i < s.size(); i++) {
+    double period = (double)(s[i].us - s[i - 1].us);
+    double rps    = 1e6 / (period * STEPS_PER_REV);
+    if (rps > lo && rps < hi) { n++; *us += period; }
+  }
+  return n;
+}
+
+// Worst ratio of the trace's accel to what the curve allows at that speed, each accel taken
+// between the mean speeds of two 10 ms windows; and the trace's duration in s.
+static double curveExcess(const std::vector<Sim::Step>& s, const TorqueCurve& curve, double* sec) {
+  const unsigned long WINDOW_US = 10000;
+  std::vector<size_t> edge;                       // first step of each window
+  for (size_t i = 0; i < s.size(); i++)
+    if (edge.empty() || s[i].us - s[edge.back()].us >= WINDOW_US) edge.push_back(i);
+  *sec = s.size() > 1 ? (s.back().us - s.front().us) / 1e6 : 0;
+  double worst = 0;
+  for (size_t w = 0; w + 2 < edge.size(); w++) {
+    double t0 = s[edge[w]].us, t1 = s[edge[w + 1]].us, t2 = s[edge[w + 2]].us;
+    double v0 = (edge[w + 1] - edge[w]) * 1e6 / ((t1 - t0) * STEPS_PER_REV);
+    double v1 = (edge[w + 2] - edge[w + 1]) * 1e6 / ((t2 - t1) * STEPS_PER_REV);
+    double a  = fabs(v1 - v0) / ((t2 - t0) / 2e6);
+    double r  = a / curve.accelAt((float)((v0 + v1) / 2));
+    if (r > worst) worst = r;
+  }
+  return worst;
+}
+
+// ── Simulated tach on the rotational motor: one pulse every STEPS_PER_REV / TACH_PPR steps ──
+
+static long rotSteps = 0;
+
+static void rotTachHook(uint8_t pin, uint8_t level) {
+  if (pin != ROT_STEP || level != HIGH) return;
+  if (++rotSteps % (STEPS_PER_REV / TACH_PPR) == 0) {
+    Sim::setInput(ROT_TACH, LOW);
+    Sim::setInput(ROT_TACH, HIGH);
+  }
+}
+
+// Poll motor for ms of virtual time.
+static void pollFor(MotorBase& motor, unsigned long ms) {
+  unsigned long start = micros();
+  while (micros() - start < ms * 1000UL) {
+    if (!motor.poll()) delayMicroseconds(100);
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* csv = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-v")) Sim::echoSerial(true);
+    else if (!strcmp(argv[i], "-csv") && i + 1 < argc) csv = argv[++i];
+  }
+  // reset() clears the echo flag; reapply it after.
+  bool echo = false;
+  for (int i = 1; i < argc; i++) echo |= !strcmp(argv[i], "-v");
+  Sim::reset();
+  Sim::echoSerial(echo);
+
+  // ── Trapezoid: blocking loop, step timer ISR, hardware pulses ──
+  STR3            rotDriver(ROT_DIR, ROT_STEP, STEPS_PER_REV);
+  STR3            hwDriver(HW_DIR, HW_STEP, STEPS_PER_REV);
+  RotationalMotor rot, hw;
+  rot.init(1, &rotDriver);
+  hw.init(2, &hwDriver);
+  Sim::traceSteps(ROT_STEP, ROT_DIR);
+  Sim::traceSteps(HW_STEP, HW_DIR);
+
+  rot.manualTrapMove(ACCEL_REVS, CRUISE_REVS, DECEL_REVS, CRUISE_RPS);
+  std::vector<Sim::Step> blocking = compare("blocking loop:", ROT_STEP, micros());
+  if (csv) {
+    if (Sim::writeStepCsv(ROT_STEP, csv)) printf("step trace written to %s\n", csv);
+    else                                  printf("cannot write %s\n", csv);
+  }
+
+  Sim::clearSteps();
+  rot.attachStepTimer();
+  rot.manualTrapMove(-ACCEL_REVS, -CRUISE_REVS, -DECEL_REVS, CRUISE_RPS);
+  std::vector<Sim::Step> isr = compare("step timer ISR:", ROT_STEP, micros());
+
+  hw.attachPulseTimer();
+  hw.manualTrapMove(ACCEL_REVS, CRUISE_REVS, DECEL_REVS, CRUISE_RPS);
+  std::vector<Sim::Step> pulses = compare("hardware pulses:", HW_STEP, micros());
+  printf("max step-time difference vs blocking: ISR %.1fus, hardware %.1fus; positions %ld / %ld\n",
+         maxDiffUs(blocking, isr), maxDiffUs(blocking, pulses), rot.positionSteps(), hw.positionSteps());
+  check(maxDiffUs(blocking, isr) <= 1 && maxDiffUs(blocking, pulses) <= 1,
+        "trapezoid: ISR and hardware pulses match the blocking loop");
+  check(rot.positionSteps() == 0 && hw.positionSteps() == 8000, "trapezoid: final positions");
+
+  // ── Tach capture: jog at a steady speed, read the speed and ripple back from the tach ──
+  TachCapture tach;
+  tach.begin(ROT_TACH, TACH_PPR);
+  Sim::setWriteHook(rotTachHook);
+  rot.setTargetVelocity(JOG_RPS, 20);     // rps, accel
+  pollFor(rot, 500);
+  tach.resetRipple();
+  pollFor(rot, 1000);
+  printf("tach capture at %.1f rps: rps %.3f, filtered %.3f, window %.3f, ripple %.2f%%\n",
+         JOG_RPS, tach.rps(), tach.filteredRPS(), tach.windowRPS(), tach.ripplePct());
+  check(near(tach.filteredRPS(), JOG_RPS, 0.01 * JOG_RPS) && tach.ripplePct() < 1,
+        "tach capture: jog speed within 1 %, ripple under 1 %");
+  rot.setTargetVelocity(0, 20);
+  rot.waitDone();
+  delay(TachCapture::STOP_US / 1000);
+  printf("tach capture after stop: rps %.3f, %lu pulses = %.2f revs (motor %.2f revs)\n",
+         tach.rps(), tach.pulses(), (float)tach.pulses() / TACH_PPR, rotSteps / (float)STEPS_PER_REV);
+  check(tach.rps() == 0 && near(tach.pulses(), rotSteps / (STEPS_PER_REV / TACH_PPR), 1),
+        "tach capture: stopped, one pulse per tach interval");
+  tach.end();
+  Sim::setWriteHook(nullptr);
+
+  // ── Resonance band: the same trapezoid crosses the band at 4x the ramp rate ──
+  const MotorBase::SpeedBand BANDS[] = {{BAND_LO, BAND_HI}};
+  rot.setResonanceBands(BANDS, 1);
+  Sim::clearSteps();
+  long bandStart = rot.positionSteps();
+  rot.manualTrapMove(ACCEL_REVS, CRUISE_REVS, DECEL_REVS, CRUISE_RPS);
+  double usFree, usBand;
+  long   nFree = bandSteps(blocking, BAND_LO, BAND_HI, &usFree);
+  long   nBand = bandSteps(Sim::steps(ROT_STEP), BAND_LO, BAND_HI, &usBand);
+  printf("resonance band %.0f-%.0f rps: %ld steps / %.1f ms in the band (%ld / %.1f ms without), "
+         "%ld steps moved\n", BAND_LO, BAND_HI, nBand, usBand / 1000, nFree, usFree / 1000,
+         rot.positionSteps() - bandStart);
+  check(nBand < nFree / 2 && rot.positionSteps() - bandStart == 8000,
+        "resonance band: under half the steps in the band, full move");
+  rot.setResonanceBands(nullptr, 0);
+
+  // ── Torque curve: the curve move against one trapezoid at the curve's top-speed rate ──
+  TorqueCurve torque;
+  torque.init(TORQUE, 4);
+  rot.setTorqueCurve(&torque);
+  Sim::clearSteps();
+  long curveStart = rot.positionSteps();
+  rot.curveMove(CURVE_REVS, CURVE_RPS);
+  double secCurve, secFlat;
+  double overCurve = curveExcess(Sim::steps(ROT_STEP), torque, &secCurve);
+  long   curveMoved = rot.positionSteps() - curveStart;
+  float  flatAccel  = torque.accelAt(CURVE_RPS);
+  float  flatRevs   = CURVE_RPS * CURVE_RPS / (2 * flatAccel);
+  Sim::clearSteps();
+  rot.manualTrapMove(-flatRevs, -(CURVE_REVS - 2 * flatRevs), -flatRevs, CURVE_RPS);
+  double overFlat = curveExcess(Sim::steps(ROT_STEP), torque, &secFlat);
+  printf("torque curve, %.0f revs at %.0f rps: %.3f s on the curve, %.3f s at a flat %.0f rev/s^2 "
+         "(%.0f%% less); peak accel / curve %.2f (flat %.2f), %ld steps moved\n", CURVE_REVS,
+         CURVE_RPS, secCurve, secFlat, flatAccel, 100 * (1 - secCurve / secFlat), overCurve,
+         overFlat, curveMoved);
+  check(secCurve < 0.9 * secFlat && overCurve <= 1.05 && curveMoved == CURVE_REVS * STEPS_PER_REV,
+        "torque curve: 10 % faster than flat, within the curve, full move");
+  rot.setTorqueCurve(nullptr);
+
+  // ── Linear stage: calibrate, then trip the end limit in the middle of a move ──
+  LiquidCrystal lcd(7, 8, 4, 5, 6, 11);
+  STR3          linDriver(LIN_DIR, LIN_STEP, 200);
+  LinearMotor   lin;
+  lin.init(3, &linDriver, END_PIN, HOME_PIN, 6.0f, 15.0f);
+  LCD::init(&lcd);
+  Sim::setWriteHook(stageHook);
+  Sim::setInput(HOME_PIN, HIGH);
+  Sim::setInput(END_PIN, HIGH);
+  lin.enableLimits();
+
+  unsigned long calStart = micros();
+  lin.calibrate(2);
+  double calSec = (micros() - calStart) / 1e6;
+  printf("calibrate: axis length %.3f revs (stage %ld steps = %.3f revs), stage at %ld\n",
+         lin.axisLengthRevs(), STAGE_END - STAGE_HOME, (STAGE_END - STAGE_HOME) / 200.0, stagePos);
+  // Home is the first clear step above the home sensor, the end the first step on the end one.
+  long axisSteps = (long)(lin.axisLengthRevs() * 200 + 0.5f);
+  check(axisSteps == STAGE_END - STAGE_HOME - 1 && stagePos == STAGE_END, "calibrate: axis length");
+
+  // ── Calibration store: save, park, "power cycle" (init again), boot from the record ──
+  lin.setMaxAccel(80);
+  lin.saveCalibration(CALIB_ADDR);
+  unsigned long saveWrites = Sim::eepromWrites();
+  lin.saveCalibration(CALIB_ADDR);
+  lin.goHome(10);                                          // parked at home, then powered off
+  lin.init(3, &linDriver, END_PIN, HOME_PIN, 6.0f, 15.0f);
+  unsigned long bootStart = micros();
+  bool restored = lin.bootCalibrate(CALIB_ADDR, 2);
+  printf("calibration store: %d-byte record, %lu bytes written (%lu on an unchanged resave); "
+         "boot %s in %.2f s (full calibrate %.2f s), axis %.3f revs, max accel %.0f\n",
+         LinearMotor::calibrationSpan(), saveWrites, Sim::eepromWrites() - saveWrites,
+         restored ? "restored" : "recalibrated", (micros() - bootStart) / 1e6, calSec,
+         lin.axisLengthRevs(), lin.maxAccel());
+  check(restored && Sim::eepromWrites() == saveWrites && (long)(lin.axisLengthRevs() * 200 + 0.5f) ==
+        axisSteps && lin.maxAccel() == 80, "calibration store: restored, no rewrite of an equal record");
+  EEPROM.write(CALIB_ADDR + 8, EEPROM.read(CALIB_ADDR + 8) ^ 0x01);   // flip one data bit
+  lin.init(3, &linDriver, END_PIN, HOME_PIN, 6.0f, 15.0f);
+  restored = lin.bootCalibrate(CALIB_ADDR, 2);
+  printf("calibration store, one bit flipped: boot %s, record %s\n",
+         restored ? "restored" : "recalibrated",
+         lin.loadCalibration(CALIB_ADDR) ? "rewritten" : "still bad");
+  check(!restored && lin.loadCalibration(CALIB_ADDR), "calibration store: bad record recalibrated");
+
+  // ── Two-speed homing: ramped approach on the limit ISR, then the creep's own latch ──
+  const int HOME_RUNS = 3;
+  double calibSec[2];
+  long   latchLo[2][2], latchHi[2][2];                     // [fast][home, end] stage steps
+  for (int fast = 0; fast < 2; fast++) {
+    lin.setHomingSpeed(fast ? 12 : 0, 80);                 // fastRPS, accel
+    unsigned long t0 = micros();
+    for (int run = 0; run < HOME_RUNS; run++) {
+      for (int e = 0; e < 2; e++) {
+        if (e) lin.findEnd(2); else lin.findHome(2);
+        if (run == 0 || stagePos < latchLo[fast][e]) latchLo[fast][e] = stagePos;
+        if (run == 0 || stagePos > latchHi[fast][e]) latchHi[fast][e] = stagePos;
+      }
+    }
+    calibSec[fast] = (micros() - t0) / 1e6 / HOME_RUNS;
+  }
+  lin.setHomingSpeed(0, 0);
+  printf("two-speed homing: calibrate %.2f s vs %.2f s creeping (%.0f %%); latches over %d runs: "
+         "home %ld..%ld (creep %ld..%ld), end %ld..%ld (creep %ld..%ld)\n",
+         calibSec[1], calibSec[0], 100.0 * calibSec[1] / calibSec[0], HOME_RUNS,
+         latchLo[1][0], latchHi[1][0], latchLo[0][0], latchHi[0][0],
+         latchLo[1][1], latchHi[1][1], latchLo[0][1], latchHi[0][1]);
+  check(calibSec[1] < 0.5 * calibSec[0], "two-speed homing: under half the creep time");
+  check(latchLo[1][0] == latchHi[0][0] && latchHi[1][0] == latchLo[0][0] &&
+        latchLo[1][1] == latchHi[0][1] && latchHi[1][1] == latchLo[0][1],
+        "two-speed homing: latches repeat and match the creep");
+
+  // ── Soft limits: full-speed jog into the end, hard limit vs the calibrated soft window ──
+  lin.setMaxAccel(80);
+  lin.findHome(2);
+  lin.setTargetVelocity(15, 80);                           // rps, accel
+  lin.waitDone();
+  bool hardHit  = lin.stoppedEarly();
+  long hardStop = stagePos;
+  lin.findHome(2);
+  lin.enableSoftLimits(0.5f);                              // marginRevs
+  unsigned long jogStart = micros();
+  lin.setTargetVelocity(15, 80);
+  lin.waitDone();
+  double softSec = (micros() - jogStart) / 1e6;
+  bool softHit  = lin.stoppedEarly();
+  long softStop = stagePos;
+  lin.goHome(15);
+  long beforeReject = lin.positionSteps();
+  lin.autoTrapMove(40, 15, 4);                             // past the end: rejected
+  bool rejected = (lin.positionSteps() == beforeReject);
+  lin.goToEnd(15);
+  bool endHit = lin.stoppedEarly();
+  printf("soft limits: 15 rps jog to the end stops %ld steps past the end sensor (limit hit %s) "
+         "without, %ld steps short of it in %.2f s (limit hit %s) with; "
+         "40-rev move %s; goToEnd stops at stage %ld (limit hit %s)\n",
+         hardStop - STAGE_END, hardHit ? "yes" : "no", STAGE_END - softStop, softSec,
+         softHit ? "yes" : "no", rejected ? "rejected" : "ran", stagePos, endHit ? "yes" : "no");
+  check(hardHit && hardStop > STAGE_END, "soft limits: jog without them trips the end limit");
+  check(!softHit && softStop == STAGE_END - 100 && rejected && !endHit && stagePos == softStop,
+        "soft limits: jog and goToEnd stop at the edge, long move rejected");
+  lin.disableSoftLimits();
+
+  lin.goHome(10);
+  long startPos = lin.positionSteps();
+  Sim::traceSteps(LIN_STEP, LIN_DIR);
+  long limitAt = 1500;                                     // steps into the move
+  Sim::setWriteHook(nullptr);
+  Sim::setInputAfterSteps(END_PIN, LOW, LIN_STEP, limitAt);
+  lin.autoTrapMove(20, 10, 3);
+  printf("end limit closed %ld steps into a 4000-step move: stopped after %ld steps\n",
+         limitAt, lin.positionSteps() - startPos);
+  check(lin.stoppedEarly() && lin.positionSteps() - startPos > limitAt &&
+        lin.positionSteps() - startPos <= limitAt + 2 * 200, "end limit: stops within limitStopRevs");
+
+  // ── Tach stall: the stage jams, the tach stops, the move stops ──
+  Sim::setInput(END_PIN, HIGH);
+  lin.attachTach(TACH_PIN, TACH_PPR, 0.1f);
+  Sim::setWriteHook(tachHook);
+  startPos = lin.positionSteps();
+  lin.autoTrapMove(-20, 10, 3);
+  printf("stage jammed %ld steps into a 4000-step move: stalled=%s, stopped after %ld steps, "
+         "tach %.2f revs\n", JAM_AT, lin.stalled() ? "yes" : "no", startPos - lin.positionSteps(),
+         lin.tachRevs());
+  check(lin.stalled() && startPos - lin.positionSteps() <= JAM_AT + 2 * 200,
+        "tach stall: stops within limitStopRevs of the jam");
+  Sim::setWriteHook(nullptr);
+
+  // ── Stall search: bisect the accel limit of the slipping stage, out and back at 8 rps ──
+  lin.detachTach();
+  Sim::setWriteHook(slipHook);
+  lin.setStallTrial(10, 4, 0.5f);                          // travelRevs, tolSteps, homeRPS
+  LinearMotor::StallLimit lim = lin.findAccelLimit(20, 400, 8, 5);   // lo, hi, cruiseRPS, resolution
+  printf("stall search (stage slips above %.0f rev/s^2): passes %.2f, fails %.2f rev/s^2 in %d runs\n",
+         SLIP_ACCEL, lim.passLevel, lim.failLevel, lim.runs);
+  check(lim.passLevel > 0.9f * SLIP_ACCEL && lim.failLevel < 1.1f * SLIP_ACCEL &&
+        lim.failLevel - lim.passLevel <= 5, "stall search: brackets the slip accel");
+
+  // ── Stall trials with two-speed homing: classified before the re-home stops on its sensor ──
+  static const char* const TRIAL_NAMES[] = {"pass", "lost", "limit", "stall", "skipped"};
+  lin.setHomingSpeed(12, 80);                              // fastRPS, accel
+  LinearMotor::StallLimit fastLim = lin.findAccelLimit(20, 400, 8, 5);
+  Sim::setWriteHook(dropHook);
+  long dropErr;
+  LinearMotor::TrialResult dropRes = lin.stallTrial(100, 8, &dropErr);   // accel, cruiseRPS
+  Sim::setWriteHook(slipHook);
+  lin.setStallTrial(40, 4, 0.5f);                          // longer than the axis
+  LinearMotor::TrialResult limitRes = lin.stallTrial(100, 8);
+  Sim::setWriteHook(jamStageHook);
+  lin.attachTach(TACH_PIN, TACH_PPR, 0.1f);
+  lin.setStallTrial(10, 4, 0.5f);
+  jamArmed = true;
+  LinearMotor::TrialResult jamRes = lin.stallTrial(100, 8);
+  lin.detachTach();
+  lin.setHomingSpeed(0, 0);
+  printf("stall trials with two-speed homing: search passes %.2f, fails %.2f rev/s^2 in %d runs; "
+         "dropping steps back %s (%ld steps), past the end %s, jammed %s\n",
+         fastLim.passLevel, fastLim.failLevel, fastLim.runs, TRIAL_NAMES[dropRes], dropErr,
+         TRIAL_NAMES[limitRes], TRIAL_NAMES[jamRes]);
+  check(fastLim.passLevel == lim.passLevel && fastLim.failLevel == lim.failLevel,
+        "stall trials: two-speed homing gives the creep's bracket");
+  check(dropRes == LinearMotor::TRIAL_LOST && limitRes == LinearMotor::TRIAL_LIMIT &&
+        jamRes == LinearMotor::TRIAL_STALL, "stall trials: lost / limit / stall classified");
+  Sim::setWriteHook(nullptr);
+
+  Display::renderMotorInfo(lin);
+  printf("LCD: [%s]\n     [%s]\n", Sim::lcdLine(0), Sim::lcdLine(1));
+  printf("virtual time %.3fs, %zu pin writes\n", Sim::nowUs() / 1e6, Sim::writes().size());
+  printf("%d checks, %d failed\n", checks, failures);
+  return failures ? 1 : 0;
+}
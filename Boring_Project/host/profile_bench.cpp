@@ -0,0 +1,427 @@
+// profile_bench.cpp
+// Benchmark of the ramp period generators over a standard move corpus, on the simulated HAL.
+// Every engine runs every move it supports; each row reports
+//   - profile error: step times against the exact speed-indexed trapezoid (or, after a
+//     limit trip, the exact limit decel from the speed at the trip),
+//   - per-step cost in estimated AVR cycles, from the operation mix of the engine's ramp
+//     and cruise steps (COST MODEL below),
+//   - the step-rate ceiling: the rate at which a ramp step's generation plus the pulse
+//     takes the whole period, and whether the move's peak rate stays under it.
+//
+// Engines:
+//   sqrt-micros   scratch runTrap(): float sqrt() per ramp step + micros() compensation
+//   austin-us     scratch runTrap(): Austin 4n+1 recurrence in integer µs (stalls early)
+//   austin-ns     scratch runTrap(): Austin 4n+1 / 4n-5 in ns + micros() compensation
+//   lib-austin    MotorBase, RAMP_AUSTIN (Q20.12 + remainder)
+//   lib-sqrt      MotorBase, RAMP_SQRT
+//   lib-table     MotorBase::tableTrapMove(), ramp table built like RampTable<N, V>
+// The scratch engines are the variants in notes/austin-recurrence-runtrap.md and only run
+// the plain trapezoids; the library engines run the limit-decel moves too.
+//
+// Usage (from host/):
+//   make bench                                  # run, write bench.csv, check bench_baseline.csv
+//   ./profile_bench -csv FILE                   # write the rows as CSV
+//   ./profile_bench -check bench_baseline.csv   # exit 1 when a row got worse than the baseline
+// After an intended change, refresh the baseline with ./profile_bench -csv bench_baseline.csv.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include "sim.h"
+#include "lib/driver/stepper/str3.h"
+#include "lib/motor/linear_motor.h"
+#include "lib/motor/step_jitter.h"
+
+// ── CONFIGURATION ──────────────────────────────────────────────────────────────
+const uint8_t DIR_PIN = 51, STEP_PIN = 53;
+const uint8_t END_PIN = 2,  HOME_PIN = 3;
+const float   LIMIT_STOP_REVS = 2.0f;     // MotorBase default: stops from maxRPS within 2 revs
+
+// Symmetric trapezoids: accelRevs up to rps, cruiseRevs, accelRevs down. limitAt >= 0 closes
+// the end limit that many steps into the move (maxRPS is the move's rps, so the limit
+// decel is rps² / (2 · LIMIT_STOP_REVS) rev/s²).
+struct Move {
+  const char* name;
+  int         spr;
+  float       accelRevs, cruiseRevs, rps;
+  long        limitAt;
+};
+
+const Move CORPUS[] = {
+  // name              spr   accel  cruise  rps  limitAt
+  {"tri-short-200",    200,  0.5f,    0,    2,   -1},
+  {"tri-short-3200",  3200,  0.25f,   0,    5,   -1},
+  {"trap-800",         800,  2,       6,   10,   -1},
+  {"cruise-long-200",  200,  2,     200,   15,   -1},
+  {"cruise-long-3200",3200,  5,     100,   10,   -1},
+  {"gentle-3200",     3200, 20,      10,    2,   -1},
+  {"fast-3200",       3200,  2,      10,   30,   -1},
+  {"limit-cruise-200", 200,  2,      20,   15,  1500},
+  {"limit-accel-3200",3200,  4,      10,   10,  6400},
+  {"limit-decel-1600",1600,  2,       4,   12,  9000},
+};
+const size_t CORPUS_SIZE = sizeof(CORPUS) / sizeof(CORPUS[0]);
+
+// Regression tolerances for -check.
+const double TOL_TIME_PCT = 0.01;         // percentage points
+const double TOL_DEV_US   = 1.0;
+// ──────────────────────────────────────────────────────────────────────────────
+
+// ── COST MODEL ────────────────────────────────────────────────────────────────
+// Approximate ATmega2560 cycles (16 MHz) per operation, call overhead included:
+// avr-gcc libgcc for 32-bit integer multiply / divide, avr-libc fplib for float.
+// A 32-bit "alu" op is an add, subtract, compare, or shift by whole bytes.
+const double F_CPU_HZ    = 16e6;
+const long   CYC_ALU     = 4;
+const long   CYC_MUL     = 56;    // __mulsi3
+const long   CYC_DIV     = 640;   // __udivmodsi4 (quotient and remainder together)
+const long   CYC_FADD    = 110;   // also float compare
+const long   CYC_FMUL    = 150;
+const long   CYC_FDIV    = 480;
+const long   CYC_FSQRT   = 500;
+const long   CYC_FCONV   = 80;    // int <-> float
+const long   CYC_PGM     = 7;     // pgm_read_word
+const long   CYC_MICROS  = 80;
+const long   CYC_CALL    = 10;    // call / ret and prologue of a non-inlined function
+const long   EMIT_CYCLES = 60;    // the pulse itself: two port writes and the loop around them
+
+struct Ops {
+  int alu, mul, div, fadd, fmul, fdiv, fsqrt, fconv, pgm, micros, call;
+
+  long cycles() const {
+    return alu * CYC_ALU + mul * CYC_MUL + div * CYC_DIV + fadd * CYC_FADD + fmul * CYC_FMUL +
+           fdiv * CYC_FDIV + fsqrt * CYC_FSQRT + fconv * CYC_FCONV + pgm * CYC_PGM +
+           micros * CYC_MICROS + call * CYC_CALL;
+  }
+};
+// ──────────────────────────────────────────────────────────────────────────────
+
+// Step edge times of one run, from 0 at the first step. limitFrom is the index of the first
+// limit-decel step (-1 when none); rampSteps / cruiseSteps count the generator's steps.
+struct Trace {
+  std::vector<unsigned long> us;
+  long                       limitFrom;
+  long                       rampSteps, cruiseSteps;
+};
+
+static long stepsOf(float revs, int spr) { return lround(revs * spr); }
+
+// ── Scratch engines (notes/austin-recurrence-runtrap.md) ──────────────────────
+
+static void fromPeriods(const std::vector<unsigned long>& periods, Trace& t) {
+  unsigned long now = 0;
+  for (size_t i = 0; i < periods.size(); i++) {
+    t.us.push_back(now);
+    now += periods[i];
+  }
+}
+
+static bool runSqrtMicros(const Move& m, Trace& t) {
+  if (m.limitAt >= 0) return false;
+  int   spr = m.spr;
+  long  a = stepsOf(m.accelRevs, spr), c = stepsOf(m.cruiseRevs, spr);
+  float accel = m.rps * m.rps / (2.0f * m.accelRevs);
+  std::vector<unsigned long> p;
+  for (long i = 1; i <= a; i++) {
+    float rps = sqrt(2.0f * accel * (float)i / spr);
+    if (rps > m.rps) rps = m.rps;
+    p.push_back((unsigned long)(1000000.0f / (rps * spr)));
+  }
+  for (long i = 0; i < c; i++) p.push_back((unsigned long)(1000000.0f / (m.rps * spr)));
+  for (long i = a; i >= 1; i--) {
+    float rps = sqrt(2.0f * accel * (float)i / spr);
+    if (rps > m.rps) rps = m.rps;
+    p.push_back((unsigned long)(1000000.0f / (rps * spr)));
+  }
+  fromPeriods(p, t);
+  t.rampSteps = 2 * a;  t.cruiseSteps = c;
+  return true;
+}
+
+// scale 1 = periods in µs, 1000 = in ns.
+static bool runAustin(const Move& m, Trace& t, unsigned long scale) {
+  if (m.limitAt >= 0) return false;
+  int   spr = m.spr;
+  long  a = stepsOf(m.accelRevs, spr), c = stepsOf(m.cruiseRevs, spr);
+  float accel = m.rps * m.rps / (2.0f * m.accelRevs);
+  unsigned long cruise = (unsigned long)(scale * 1000000.0f / (m.rps * spr));
+  unsigned long step   = (unsigned long)(scale * 1000000.0f / sqrt(2.0f * accel * (float)spr));
+  std::vector<unsigned long> p;
+  for (long n = 1; n <= a; n++) {
+    if (step < cruise) step = cruise;
+    p.push_back(step / scale);
+    step -= 2UL * step / (unsigned long)(4 * n + 1);
+  }
+  for (long i = 0; i < c; i++) p.push_back(cruise / scale);
+  step = cruise;
+  for (long n = a; n >= 1; n--) {
+    p.push_back(step / scale);
+    if (n >= 2) step += 2UL * step / (unsigned long)(4 * n - 5);
+  }
+  fromPeriods(p, t);
+  t.rampSteps = 2 * a;  t.cruiseSteps = c;
+  return true;
+}
+
+static bool runAustinUs(const Move& m, Trace& t) { return runAustin(m, t, 1); }
+static bool runAustinNs(const Move& m, Trace& t) { return runAustin(m, t, 1000); }
+
+// ── Library engines: MotorBase on the simulated HAL ───────────────────────────
+
+enum LibMode { LIB_AUSTIN, LIB_SQRT, LIB_TABLE };
+
+static bool runLibrary(const Move& m, Trace& t, LibMode mode) {
+  Sim::reset();
+  Sim::recordWrites(false);
+  Sim::traceSteps(STEP_PIN, DIR_PIN);
+
+  STR3        driver(DIR_PIN, STEP_PIN, m.spr);
+  LinearMotor motor;
+  StepJitter  phases;                               // only its per-phase step counts are used
+  motor.init(1, &driver, END_PIN, HOME_PIN, 6.0f, m.rps);
+  motor.setJitterProbe(&phases);
+  if (m.limitAt >= 0) {
+    motor.enableLimits();
+    Sim::setInputAfterSteps(END_PIN, LOW, STEP_PIN, m.limitAt);
+  }
+
+  long a = stepsOf(m.accelRevs, m.spr), c = stepsOf(m.cruiseRevs, m.spr);
+  std::vector<uint16_t> table;
+  if (mode == LIB_TABLE) {
+    unsigned long v = lround(m.rps * m.spr);
+    for (long n = 1; n <= a; n++) table.push_back(ramp_table_detail::periodWord(n, a, v));
+    RampProfile ramp = {table.data(), (unsigned int)a, v, ramp_table_detail::periodWord(a, a, v)};
+    motor.tableTrapMove(ramp, (float)(2 * a + c) / m.spr);
+  } else {
+    if (mode == LIB_SQRT) motor.setRampMode(MotorBase::RAMP_SQRT);
+    motor.manualTrapMove(m.accelRevs, m.cruiseRevs, m.accelRevs, m.rps);
+  }
+  motor.setJitterProbe(nullptr);
+  if (m.limitAt >= 0) motor.disableLimits();        // frees the ISR slot for the next run
+
+  const std::vector<Sim::Step>& s = Sim::steps(STEP_PIN);
+  for (size_t i = 0; i < s.size(); i++) t.us.push_back(s[i].us - s[0].us);
+  long limitSteps = phases.steps(4);                // MotorBase phases: 1 accel ... 4 limit
+  t.limitFrom     = (m.limitAt >= 0 && limitSteps > 0) ? (long)s.size() - limitSteps : -1;
+  t.cruiseSteps   = phases.steps(2);
+  t.rampSteps     = (long)s.size() - t.cruiseSteps;
+  return true;
+}
+
+static bool runLibAustin(const Move& m, Trace& t) { return runLibrary(m, t, LIB_AUSTIN); }
+static bool runLibSqrt(const Move& m, Trace& t)   { return runLibrary(m, t, LIB_SQRT); }
+static bool runLibTable(const Move& m, Trace& t)  { return runLibrary(m, t, LIB_TABLE); }
+
+// ── Engine table ──────────────────────────────────────────────────────────────
+// Operation mix of one ramp step and one cruise step, counted from the code each engine runs
+// per step (library: nextStepPeriod() dispatch + rampUp / rampDown; scratch: the loop body
+// of runTrap() minus the pulse).
+
+struct Engine {
+  const char* name;
+  Ops         ramp, cruise;
+  bool      (*run)(const Move&, Trace&);
+};
+
+const Engine ENGINES[] = {
+  //              alu mul div fadd fmul fdiv fsqrt fconv pgm micros call
+  {"sqrt-micros", { 5,  0,  0,   1,   3,   2,    1,    4,  0,    2,   1},
+                  { 2,  0,  0,   0,   0,   0,    0,    0,  0,    0,   0}, runSqrtMicros},
+  {"austin-us",   { 6,  0,  1,   0,   0,   0,    0,    0,  0,    0,   0},
+                  { 2,  0,  0,   0,   0,   0,    0,    0,  0,    0,   0}, runAustinUs},
+  {"austin-ns",   { 8,  0,  2,   0,   0,   0,    0,    0,  0,    2,   0},
+                  { 2,  0,  0,   0,   0,   0,    0,    0,  0,    0,   0}, runAustinNs},
+  {"lib-austin",  {28,  0,  1,   0,   0,   0,    0,    0,  0,    0,   2},
+                  { 9,  0,  0,   0,   0,   0,    0,    0,  0,    0,   1}, runLibAustin},
+  {"lib-sqrt",    {16,  0,  0,   1,   4,   1,    1,    4,  0,    0,   4},
+                  { 9,  0,  0,   0,   0,   0,    0,    0,  0,    0,   1}, runLibSqrt},
+  {"lib-table",   {18,  0,  0,   0,   0,   0,    0,    0,  1,    0,   2},
+                  { 9,  0,  0,   0,   0,   0,    0,    0,  0,    0,   1}, runLibTable},
+};
+const size_t ENGINE_COUNT = sizeof(ENGINES) / sizeof(ENGINES[0]);
+
+// ── Profile error ─────────────────────────────────────────────────────────────
+
+struct Row {
+  std::string engine, move;
+  int         spr;
+  long        steps, plannedSteps;
+  double      peakSps, timeErrPct, maxDevUs, rmsDevUs;
+  long        rampCycles, cruiseCycles, avgCycles;
+  double      ceilingSps;
+  bool        fits;
+};
+
+// Reference: the exact speed-indexed periods every engine approximates, T_n = 1 / sqrt(2·a·n)
+// in double, summed. This isolates each generator's error from the T_n convention they all
+// share, which by itself runs a ramp ~1.5·T_1 short of continuous kinematics (see
+// motion_sim for that comparison).
+static double idealUs(double accel, long n) { return 1e6 / sqrt(2.0 * accel * n); }
+
+// Trapezoid: step k of accel has ramp index k + 1, decel counts back down to 1.
+// Limit trip: the steps after it against the limit rate from the speed of the last step
+// before it, starting at the ramp index of that speed.
+static void profileError(const Move& m, const Trace& t, Row& r) {
+  double maxDev = 0, sumSq = 0, tEnd = 0, tRef = 0, ref = 0;
+  long   count  = 0;
+  if (t.limitFrom < 0) {
+    long   a = stepsOf(m.accelRevs, m.spr), c = stepsOf(m.cruiseRevs, m.spr);
+    double v = m.rps * m.spr, accel = v * v / (2.0 * a);
+    r.plannedSteps = 2 * a + c;
+    for (size_t i = 0; i < t.us.size(); i++) {
+      double dev = t.us[i] - ref;
+      sumSq += dev * dev;
+      if (fabs(dev) > fabs(maxDev)) maxDev = dev;
+      count++;
+      tEnd = t.us[i];
+      tRef = ref;
+      long k = i;
+      ref += (k < a) ? idealUs(accel, k + 1) : (k < a + c) ? 1e6 / v
+                     : idealUs(accel, (k < 2 * a + c) ? 2 * a + c - k : 1);
+    }
+  } else {
+    long   i0 = t.limitFrom;
+    double v  = (i0 > 0) ? 1e6 / (t.us[i0] - t.us[i0 - 1]) : 0;      // steps/s at the trip
+    double aL = m.rps * m.rps / (2.0 * LIMIT_STOP_REVS) * m.spr;     // steps/s²
+    long   n  = (long)(v * v / (2.0 * aL));
+    r.plannedSteps = n;
+    for (size_t j = 0; i0 + j < t.us.size(); j++) {
+      double dev = (t.us[i0 + j] - t.us[i0]) - ref;
+      sumSq += dev * dev;
+      if (fabs(dev) > fabs(maxDev)) maxDev = dev;
+      count++;
+      tEnd = t.us[i0 + j] - t.us[i0];
+      tRef = ref;
+      ref += idealUs(aL, (n - (long)j > 1) ? n - (long)j : 1);
+    }
+  }
+  r.steps      = (t.limitFrom < 0) ? (long)t.us.size() : (long)t.us.size() - t.limitFrom;
+  r.timeErrPct = (tRef > 0) ? 100.0 * (tEnd - tRef) / tRef : 0;
+  r.maxDevUs   = maxDev;
+  r.rmsDevUs   = count ? sqrt(sumSq / count) : 0;
+
+  unsigned long minPeriod = 0;
+  for (size_t i = 1; i < t.us.size(); i++) {
+    unsigned long p = t.us[i] - t.us[i - 1];
+    if (minPeriod == 0 || p < minPeriod) minPeriod = p;
+  }
+  r.peakSps = minPeriod ? 1e6 / minPeriod : 0;
+}
+
+static Row measure(const Engine& e, const Move& m, const Trace& t) {
+  Row r;
+  r.engine = e.name;
+  r.move   = m.name;
+  r.spr    = m.spr;
+  profileError(m, t, r);
+  r.rampCycles   = e.ramp.cycles();
+  r.cruiseCycles = e.cruise.cycles();
+  long total     = t.rampSteps + t.cruiseSteps;
+  r.avgCycles    = total ? (r.rampCycles * t.rampSteps + r.cruiseCycles * t.cruiseSteps) / total : 0;
+  r.ceilingSps   = F_CPU_HZ / (r.rampCycles + EMIT_CYCLES);
+  r.fits         = r.peakSps <= r.ceilingSps;
+  return r;
+}
+
+// ── Output and baseline check ─────────────────────────────────────────────────
+
+static const char* CSV_HEADER = "engine,move,spr,steps,planned_steps,peak_sps,time_err_pct,"
+                                "max_dev_us,rms_dev_us,ramp_cycles,cruise_cycles,avg_cycles,"
+                                "ceiling_sps,fits";
+
+static void writeCsvRow(FILE* f, const Row& r) {
+  fprintf(f, "%s,%s,%d,%ld,%ld,%.0f,%.4f,%.1f,%.2f,%ld,%ld,%ld,%.0f,%d\n",
+          r.engine.c_str(), r.move.c_str(), r.spr, r.steps, r.plannedSteps, r.peakSps,
+          r.timeErrPct, r.maxDevUs, r.rmsDevUs, r.rampCycles, r.cruiseCycles, r.avgCycles,
+          r.ceilingSps, r.fits ? 1 : 0);
+}
+
+static bool readCsv(const char* path, std::map<std::string, Row>& rows) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    char engine[32], move[32];
+    int  fits;
+    Row  r;
+    if (sscanf(line, "%31[^,],%31[^,],%d,%ld,%ld,%lf,%lf,%lf,%lf,%ld,%ld,%ld,%lf,%d",
+               engine, move, &r.spr, &r.steps, &r.plannedSteps, &r.peakSps, &r.timeErrPct,
+               &r.maxDevUs, &r.rmsDevUs, &r.rampCycles, &r.cruiseCycles, &r.avgCycles,
+               &r.ceilingSps, &fits) != 14) continue;   // header
+    r.engine = engine;
+    r.move   = move;
+    r.fits   = fits != 0;
+    rows[r.engine + "," + r.move] = r;
+  }
+  fclose(f);
+  return true;
+}
+
+// Prints every row that got worse than its baseline; returns the number of regressions.
+static int check(const std::vector<Row>& rows, const std::map<std::string, Row>& base) {
+  int bad = 0;
+  for (size_t i = 0; i < rows.size(); i++) {
+    const Row& r = rows[i];
+    std::map<std::string, Row>::const_iterator it = base.find(r.engine + "," + r.move);
+    if (it == base.end()) { printf("new row (not in baseline): %s %s\n", r.engine.c_str(), r.move.c_str()); continue; }
+    const Row& b = it->second;
+    const char* what = nullptr;
+    if      (r.steps != b.steps)                                      what = "step count changed";
+    else if (fabs(r.timeErrPct) > fabs(b.timeErrPct) + TOL_TIME_PCT) what = "time error grew";
+    else if (fabs(r.maxDevUs) > fabs(b.maxDevUs) + TOL_DEV_US)        what = "max deviation grew";
+    else if (r.rmsDevUs > b.rmsDevUs + TOL_DEV_US)                    what = "rms deviation grew";
+    else if (r.avgCycles > b.avgCycles || r.rampCycles > b.rampCycles) what = "cycle cost grew";
+    else if (b.fits && !r.fits)                                       what = "peak rate above ceiling";
+    if (what) {
+      printf("REGRESSION %s %s: %s\n", r.engine.c_str(), r.move.c_str(), what);
+      bad++;
+    }
+  }
+  return bad;
+}
+
+int main(int argc, char** argv) {
+  const char* csv = nullptr;
+  const char* baseline = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if      (!strcmp(argv[i], "-csv")   && i + 1 < argc) csv = argv[++i];
+    else if (!strcmp(argv[i], "-check") && i + 1 < argc) baseline = argv[++i];
+  }
+
+  std::vector<Row> rows;
+  printf("%-12s %-17s %5s %8s %8s %9s %8s %8s %5s %5s %5s %8s %s\n", "engine", "move", "spr",
+         "steps", "planned", "peak/s", "time%", "maxdev", "ramp", "cruise", "avg", "ceiling", "fits");
+  for (size_t e = 0; e < ENGINE_COUNT; e++) {
+    for (size_t m = 0; m < CORPUS_SIZE; m++) {
+      Trace t;
+      t.limitFrom = -1;
+      if (!ENGINES[e].run(CORPUS[m], t)) continue;
+      Row r = measure(ENGINES[e], CORPUS[m], t);
+      rows.push_back(r);
+      printf("%-12s %-17s %5d %8ld %8ld %9.0f %+8.3f %+8.0f %5ld %5ld %5ld %8.0f %s\n",
+             r.engine.c_str(), r.move.c_str(), r.spr, r.steps, r.plannedSteps, r.peakSps,
+             r.timeErrPct, r.maxDevUs, r.rampCycles, r.cruiseCycles, r.avgCycles, r.ceilingSps,
+             r.fits ? "yes" : "NO");
+    }
+  }
+
+  if (csv) {
+    FILE* f = fopen(csv, "w");
+    if (!f) { printf("cannot write %s\n", csv); return 2; }
+    fprintf(f, "%s\n", CSV_HEADER);
+    for (size_t i = 0; i < rows.size(); i++) writeCsvRow(f, rows[i]);
+    fclose(f);
+    printf("%zu rows written to %s\n", rows.size(), csv);
+  }
+
+  if (baseline) {
+    std::map<std::string, Row> base;
+    if (!readCsv(baseline, base)) { printf("cannot read %s\n", baseline); return 2; }
+    int bad = check(rows, base);
+    printf("%s: %d regression%s against %s\n", bad ? "FAIL" : "OK", bad, bad == 1 ? "" : "s", baseline);
+    return bad ? 1 : 0;
+  }
+  return 0;
+}
@@ -0,0 +1,55 @@
+// static_step_driver.h
+// Step/direction driver with its pins and steps-per-rev fixed at compile time.
+// Same protocol as StepMotorDriver (STR3 / ST5 / ST10 without enable), but every method is
+// inline and the class is final: bound to Motor<Driver> (motor.h), the blocking step loop
+// calls step() directly and the pin writes fold to FastPinT<PIN> port instructions.
+// Through a plain StepperDriver* it still works as an ordinary virtual driver.
+//
+// Usage:
+//   Motor<StaticSTR3<51, 53, 200> > xMotor;   // dirPin, stepPin, stepsPerRev
+//   xMotor.init(1);
+
+#pragma once
+
+#include "../stepper_driver.h"
+#include "../gpio/fast_pin.h"
+#include "step_motor_driver.h"
+
+template <uint8_t DIR_PIN, uint8_t STEP_PIN, int STEPS_PER_REV, bool INVERT_DIR = false>
+class StaticStepDriver final : public StepperDriver {
+public:
+  void init() override {
+    FastPinT<DIR_PIN>::output();
+    FastPinT<STEP_PIN>::output();
+  }
+
+  // HIGH for stepPeriodUs/2, then LOW for the rest of the period.
+  void step(unsigned long stepPeriodUs) override {
+    FastPinT<STEP_PIN>::high();
+    delayMicroseconds(stepPeriodUs / 2);
+    FastPinT<STEP_PIN>::low();
+    delayMicroseconds(stepPeriodUs - stepPeriodUs / 2);
+  }
+
+  void stepBurst(const unsigned long* periods, uint8_t count) override {
+    for (uint8_t i = 0; i < count; i++) step(periods[i]);
+  }
+
+  void pulse() override {
+    FastPinT<STEP_PIN>::high();
+    delayMicroseconds(StepMotorDriver::PULSE_US);
+    FastPinT<STEP_PIN>::low();
+  }
+
+  void setDirection(bool forward) override {
+    FastPinT<DIR_PIN>::write(!(forward ^ INVERT_DIR));
+  }
+
+  int stepsPerRev() const override { return STEPS_PER_REV; }
+
+  int stepPin() const override { return STEP_PIN; }
+};
+
+// STR3 has no enable pin, so the static driver covers it completely.
+template <uint8_t DIR_PIN, uint8_t STEP_PIN, int STEPS_PER_REV, bool INVERT_DIR = false>
+using StaticSTR3 = StaticStepDriver<DIR_PIN, STEP_PIN, STEPS_PER_REV, INVERT_DIR>;